@@ -0,0 +1,106 @@
+/*
+ * Throughput of asynchronous dispatch with a growing number of producer threads, shared queue vs sharded queues
+ *
+ * usage: bench-async-scaling [MESSAGES_PER_THREAD] [MAX_THREADS]
+ */
+#include "cxlog/LoggerFactory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace cxlog;
+using Clock = std::chrono::steady_clock;
+
+/* Sink which only counts, so that the queue is what is being measured */
+class NullProvider : public ILoggerProvider
+{
+    class NullLogger : public ILogger
+    {
+    public:
+        explicit NullLogger(std::atomic<std::uint64_t>& count) : _count(count) {}
+
+        void Log(LogLevel, std::string_view) override { _count.fetch_add(1, std::memory_order_relaxed); }
+        void Log(const LogRecord&) override { _count.fetch_add(1, std::memory_order_relaxed); }
+        [[nodiscard]] bool IsEnabled(LogLevel) const noexcept override { return true; }
+
+    private:
+        std::atomic<std::uint64_t>& _count;
+    };
+
+public:
+    std::shared_ptr<ILogger> GetLogger(const std::string&) override { return std::make_shared<NullLogger>(Count); }
+    [[nodiscard]] std::string_view GetName() const override { return "NullProvider"; }
+
+    std::atomic<std::uint64_t> Count {0};
+};
+
+struct Result
+{
+    double produced;    /**< Messages per second accepted by the loggers */
+    double delivered;   /**< Messages per second handed over to the sink */
+};
+
+static Result Run(DispatchMode mode, int threads, int messages)
+{
+    auto provider = std::make_shared<NullProvider>();
+
+    LoggerOptions options;
+    options.Async = AsyncOptions{};
+    options.Async->Mode = mode;
+    options.Async->Capacity = 16384;
+    options.Async->BlockTimeout = std::chrono::seconds(60);
+
+    LoggerFactory factory({ provider }, options);
+    auto l = factory.CreateLogger("bench");
+
+    std::atomic<int> ready {0};
+    std::vector<std::thread> producers;
+    auto start = Clock::now();
+
+    for (int t = 0; t < threads; ++t)
+    {
+        producers.emplace_back([&] {
+            ready.fetch_add(1);
+            while (ready.load() < threads)
+                std::this_thread::yield();
+
+            for (int i = 0; i < messages; ++i)
+                l->Log(LogLevel::Info, "benchmark message of a typical length, with nothing to format");
+        });
+    }
+
+    for (auto& producer : producers)
+        producer.join();
+    auto produced = Clock::now();
+
+    factory.Flush().get();
+    auto delivered = Clock::now();
+
+    double total = static_cast<double>(threads) * messages;
+    return { total / std::chrono::duration<double>(produced - start).count(),
+             total / std::chrono::duration<double>(delivered - start).count() };
+}
+
+int main(int argc, char** argv)
+{
+    int messages = argc > 1 ? std::atoi(argv[1]) : 200'000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2])
+                              : static_cast<int>(std::max(4u, std::thread::hardware_concurrency()));
+
+    std::printf("%8s %22s %22s\n", "threads", "shared (M msg/s)", "sharded (M msg/s)");
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        auto shared = Run(DispatchMode::Shared, threads, messages);
+        auto sharded = Run(DispatchMode::Sharded, threads, messages);
+
+        std::printf("%8d %10.2f / %-9.2f %10.2f / %-9.2f\n", threads,
+                    shared.produced / 1e6, shared.delivered / 1e6, sharded.produced / 1e6, sharded.delivered / 1e6);
+    }
+    std::printf("(produced / delivered)\n");
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Cost of escaping messages for JSON output: plain copy vs byte by byte escaping vs AppendEscaped()
+ *
+ * usage: bench-escape [ITERATIONS]
+ */
+#include "cxlog/Escape.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace cxlog;
+using Clock = std::chrono::steady_clock;
+
+/* Escaping as done before the vectorized scan */
+static void AppendEscapedBytewise(std::string& out, std::string_view text)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    for (char c : text)
+    {
+        switch (c)
+        {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out.append("\\u00");
+                    out.push_back(hex[(c >> 4) & 0xf]);
+                    out.push_back(hex[c & 0xf]);
+                }
+                else
+                {
+                    out.push_back(c);
+                }
+        }
+    }
+}
+
+template<typename F>
+static double NsPerMessage(int iterations, F&& fn)
+{
+    std::string out;
+    out.reserve(8192);
+
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        out.clear();
+        fn(out);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    /* Keep the result observable */
+    if (out.size() == 1)
+        std::puts("");
+    return elapsed / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    std::printf("%-22s %10s %12s %12s\n", "message", "copy (ns)", "bytewise (ns)", "escaped (ns)");
+    for (std::size_t size : {64, 256, 1024})
+    {
+        for (bool dirty : {false, true})
+        {
+            std::string message;
+            while (message.size() < size)
+                message += dirty ? "key=\"value\"\tnext " : "request served in 12ms ";
+            message.resize(size);
+
+            auto copy = NsPerMessage(iterations, [&](std::string& out) { out.append(message); });
+            auto bytewise = NsPerMessage(iterations, [&](std::string& out) { AppendEscapedBytewise(out, message); });
+            auto escaped = NsPerMessage(iterations, [&](std::string& out) { AppendEscaped(out, message, EscapeMode::Json); });
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "%zu bytes, %s", size, dirty ? "quoted" : "clean");
+            std::printf("%-22s %10.1f %12.1f %12.1f\n", name, copy, bytewise, escaped);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Compares FileProvider backends, durability tiers and compression codecs: time per line, bytes written per line and
+ * tail latency of individual Log calls
+ *
+ * usage: bench-file-backends [DIR] [LINES]
+ */
+#include "cxlog/FileProvider.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace cxlog;
+using Clock = std::chrono::steady_clock;
+
+static void Run(const char* name, const std::filesystem::path& dir, FileProviderOptions opt, int lines)
+{
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    std::vector<std::int64_t> latencies(static_cast<std::size_t>(lines));
+    std::string message(80, 'x');
+
+    auto start = Clock::now();
+    {
+        FileProvider provider(dir / "", opt);
+        if (opt.backend != provider.Backend() || opt.compression != provider.Compression())
+        {
+            std::printf("%-16s unavailable\n", name);
+            return;
+        }
+
+        auto l = provider.GetLogger("bench");
+        for (int i = 0; i < lines; ++i)
+        {
+            auto before = Clock::now();
+            l->Log(LogLevel::Info, message);
+            latencies[static_cast<std::size_t>(i)] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count();
+        }
+        provider.Shutdown(Clock::now()).wait();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::uintmax_t bytes = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir))
+        bytes += entry.file_size();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[static_cast<std::size_t>(p * (lines - 1))]; };
+
+    std::printf("%-16s %8.1f ns/line %6.1f B/line %8.1f MB/s   p50 %6lld ns   p99.9 %8lld ns   max %9lld ns\n", name,
+                elapsed * 1e9 / lines, static_cast<double>(bytes) / lines, static_cast<double>(bytes) / elapsed / 1e6,
+                static_cast<long long>(percentile(0.5)), static_cast<long long>(percentile(0.999)),
+                static_cast<long long>(latencies.back()));
+
+    std::filesystem::remove_all(dir);
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path dir = argc > 1 ? argv[1] : "/tmp/cxlog-bench";
+    int lines = argc > 2 ? std::atoi(argv[2]) : 1'000'000;
+
+    FileProviderOptions stream;
+    stream.pattern = "%F %T.%f [%l] %c: %v%n";
+
+    auto uring = stream;
+    uring.backend = FileBackend::IoUring;
+
+    auto uringSync = uring;
+    uringSync.uringSync = true;
+
+    auto uringSqPoll = uring;
+    uringSqPoll.uringSqPoll = true;
+
+    /* Every line durable: shows how far group commit amortizes fdatasync */
+    auto groupCommit = stream;
+    groupCommit.durability = FileDurability::GroupCommit;
+    groupCommit.durableLevel = LogLevel::Info;
+
+    auto lz = stream;
+    lz.compression = FileCompression::Lz;
+
+    auto zlib = stream;
+    zlib.compression = FileCompression::Zlib;
+
+    auto zstd = stream;
+    zstd.compression = FileCompression::Zstd;
+
+    Run("ofstream", dir, stream, lines);
+    Run("group commit", dir, groupCommit, lines / 10);
+    Run("io_uring", dir, uring, lines);
+    Run("io_uring+fsync", dir, uringSync, lines);
+    Run("io_uring+sqpoll", dir, uringSqPoll, lines);
+    Run("lz frames", dir, lz, lines);
+    Run("zlib frames", dir, zlib, lines);
+    Run("zstd frames", dir, zstd, lines);
+    return 0;
+}
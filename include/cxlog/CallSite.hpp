@@ -0,0 +1,204 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/LogLevel.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Kind of a format argument, as recorded in the call site metadata
+ */
+enum class ArgType : std::uint8_t
+{
+    None,       /**< Terminates CallSite::ArgTypes */
+    Bool,
+    Char,
+    Int,        /**< Signed integer */
+    UInt,       /**< Unsigned integer */
+    Float,
+    String,     /**< Anything convertible to std::string_view */
+    Pointer,
+    Callable,   /**< Deferred argument, invoked when the message is logged */
+    Custom,     /**< Any other streamable type */
+};
+
+/**
+ * @brief Runtime switch of a single logging statement
+ */
+enum class SiteMode : std::uint8_t
+{
+    Default,    /**< Logged if the logger's level and rules allow it */
+    Enabled,    /**< Logged regardless of the minimum levels of the logger rules */
+    Disabled,   /**< Never logged */
+};
+
+/**
+ * @brief Static description of a single logging statement
+ *
+ * @details Sites are compile time constants created by the CXLOG_* macros (see GLog.hpp), one per statement, and
+ * registered before main() runs, so that RegisteredCallSites() lists every statement of the program and of the
+ * shared libraries loaded into it, whether executed or not. The address of a site identifies the statement for the
+ * life of the process; loggers receive it instead of the strings it describes (see ILogger::LogAt() and
+ * LogRecord::Site).
+ *
+ * Mode is the only mutable part of a site. It is checked with a single relaxed load before anything else is done
+ * for the statement, and is set through SetCallSiteMode() or ApplyCallSiteControl().
+ */
+struct CallSite
+{
+    LogLevel Level;                     /**< Severity of the statement */
+    const char* File;                   /**< Source file, as given by __FILE__ */
+    std::uint32_t Line;                 /**< Source line */
+    const char* Function;               /**< Enclosing function, as given by __func__ */
+    std::string_view Format;            /**< Format string, "{}" standing for the arguments */
+    const ArgType* ArgTypes;            /**< Kind of each argument, terminated by ArgType::None */
+    const std::uint32_t* ArgOffsets;    /**< Offset of the placeholder of each argument in Format, Format.size() if none */
+    std::uint32_t ArgCount;             /**< Number of arguments */
+    std::atomic<SiteMode>* Mode;        /**< Runtime switch, nullptr if the site can't be switched */
+};
+
+/**
+ * @return All registered call sites, ordered by file and line
+ */
+CXLOG_API std::vector<const CallSite*> RegisteredCallSites();
+
+/**
+ * @brief Switches all sites matching the selector, including sites registered later, e.g. by a shared library
+ *
+ * @details Selectors:
+ *  - `file:line`   statement at given line; file is the path as given to the compiler, or any trailing part of it
+ *                  made of whole path components, e.g. "Server.cxx:120" or "net/Server.cxx:120"
+ *  - `file`        all statements of the file
+ *  - `name()`      all statements of functions with given name (as given by __func__)
+ *  - `"text"`      all statements whose format contains the text
+ *
+ * Later calls take precedence over earlier ones for the sites they match.
+ *
+ * @return Number of matching sites registered so far
+ * @throws std::invalid_argument if the selector is malformed
+ */
+CXLOG_API std::size_t SetCallSiteMode(std::string_view selector, SiteMode mode);
+
+/**
+ * @brief Replaces all site switches with the ones listed in a control file
+ *
+ * @details Every line of the file is one of `+selector` (SiteMode::Enabled), `-selector` (SiteMode::Disabled) or
+ * `=selector` (SiteMode::Default), see SetCallSiteMode() for the selectors. Empty lines and lines starting with '#'
+ * are ignored. Sites not matched by any line return to SiteMode::Default, so the file can be edited and applied again
+ * to change the set of switched statements at runtime.
+ *
+ * The whole file is parsed before anything is switched, so a malformed file leaves the switches untouched.
+ *
+ * @return Number of registered sites which are not in SiteMode::Default afterwards
+ * @throws std::runtime_error if the file can't be read, std::invalid_argument (naming the line) if it is malformed
+ */
+CXLOG_API std::size_t ApplyCallSiteControl(const std::string& path);
+
+namespace details
+{
+    /** Part of a call site known where the statement is written, i.e. everything but the argument types */
+    struct SiteSource
+    {
+        LogLevel Level;
+        const char* File;
+        std::uint32_t Line;
+        const char* Function;
+        std::string_view Format;
+    };
+
+    /**
+     * @brief Adds a site to the registry
+     * @return true
+     */
+    CXLOG_API bool RegisterCallSite(const CallSite* site) noexcept;
+
+    template<typename T>
+    constexpr ArgType ArgTypeOf() noexcept
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return ArgType::Bool;
+        else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, wchar_t> || std::is_same_v<T, char16_t>
+                           || std::is_same_v<T, char32_t>)
+            return ArgType::Char;
+        else if constexpr (std::is_integral_v<T>)
+            return std::is_signed_v<T> ? ArgType::Int : ArgType::UInt;
+        else if constexpr (std::is_floating_point_v<T>)
+            return ArgType::Float;
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            return ArgType::String;
+        else if constexpr (std::is_invocable_v<T&>)
+            return ArgType::Callable;
+        else if constexpr (std::is_pointer_v<T>)
+            return ArgType::Pointer;
+        else
+            return ArgType::Custom;
+    }
+
+    /* Offsets of the first N placeholders; one extra element keeps the array non-empty */
+    template<std::size_t N>
+    constexpr std::array<std::uint32_t, N + 1> PlaceholderOffsets(std::string_view format) noexcept
+    {
+        std::array<std::uint32_t, N + 1> offsets {};
+        std::size_t pos = 0;
+        for (auto& offset : offsets)
+        {
+            auto idx = format.find("{}", pos);
+            offset = static_cast<std::uint32_t>(idx == std::string_view::npos ? format.size() : idx);
+            pos = idx == std::string_view::npos ? format.size() : idx + 2;
+        }
+        return offsets;
+    }
+
+    /**
+     * @brief Complete call site of a statement, once the argument types are known
+     *
+     * @details Site is a constant; Registered is dynamically initialized before main(), which is what registers
+     * the site without it ever being executed. The registry applies the switches set so far to Mode at that point.
+     */
+    template<const SiteSource* Source, typename... Args>
+    struct SiteOf
+    {
+        static constexpr ArgType Types[] = { ArgTypeOf<Args>()..., ArgType::None };
+        static constexpr auto Offsets = PlaceholderOffsets<sizeof...(Args)>(Source->Format);
+        static inline std::atomic<SiteMode> Mode {SiteMode::Default};
+
+        static constexpr CallSite Site {
+            Source->Level,
+            Source->File,
+            Source->Line,
+            Source->Function,
+            Source->Format,
+            Types,
+            Offsets.data(),
+            sizeof...(Args),
+            &Mode,
+        };
+
+        static inline const bool Registered = RegisterCallSite(&Site);
+    };
+
+    /**
+     * @brief Logs through the site of a statement; used by the CXLOG_* macros
+     * @param format Format of the statement, already part of Source
+     */
+    template<const SiteSource* Source, typename Logger, typename... Args>
+    void LogAtSite(Logger& logger, std::string_view format, Args&& ...args)
+    {
+        using Site = SiteOf<Source, std::decay_t<Args>...>;
+
+        (void)Site::Registered;
+        (void)format;
+        logger.LogAt(Site::Site, std::forward<Args>(args)...);
+    }
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,130 @@
+#pragma once
+#include "cxlog/defs.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * Codec of block compressed FileProvider output
+ */
+enum class FileCompression : std::uint8_t {
+    None,           /**< Plain text files */
+    Lz,             /**< Built-in LZ77 codec, always available */
+    Zlib,           /**< zlib, if cxlog was built with it; Lz otherwise */
+    Zstd,           /**< zstd, if cxlog was built with it; Lz otherwise */
+};
+
+/**
+ * @brief Layout of block compressed log files (".log.cxz")
+ *
+ * @details A file is a FileHeader followed by frames. Every frame is a FrameHeader followed by the compressed bytes of
+ * a run of whole lines, compressed independently of all other frames. When the file is closed, an index of all
+ * frames (FrameEntry each) is appended, followed by an IndexFooter locating it; a file whose writer didn't get to
+ * close it has no index, and is read by walking the frame headers instead. Integers are in host byte order.
+ */
+namespace compressed_log
+{
+    static constexpr char FileMagic[8] = { 'C', 'X', 'L', 'O', 'G', 'Z', '1', '\0' };
+    static constexpr char IndexMagic[8] = { 'C', 'X', 'L', 'Z', 'I', 'D', 'X', '\0' };
+    static constexpr std::uint32_t FrameMagic = 0x46585a43;    /**< "CZXF" */
+
+    /** Frame flag: payload is stored uncompressed, as compressing it didn't make it smaller */
+    static constexpr std::uint32_t FrameStored = 1;
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint8_t codec;             /**< FileCompression */
+        std::uint8_t reserved[3];
+        std::uint32_t frameSize;        /**< Uncompressed size frames were cut at */
+    };
+
+    struct FrameHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t size;             /**< Bytes of payload following the header */
+        std::uint32_t rawSize;          /**< Bytes of the payload once decompressed */
+        std::uint32_t flags;
+    };
+
+    struct FrameEntry
+    {
+        std::uint64_t offset;           /**< Offset of the FrameHeader in the file */
+        std::uint64_t rawOffset;        /**< Offset of the frame's first byte in the uncompressed log */
+        std::uint32_t size;
+        std::uint32_t rawSize;
+    };
+
+    struct IndexFooter
+    {
+        std::uint64_t indexOffset;      /**< Offset of the first FrameEntry */
+        std::uint64_t count;            /**< Number of entries */
+        char magic[8];
+    };
+
+    static_assert(sizeof(FileHeader) == 16 && sizeof(FrameHeader) == 16 && sizeof(FrameEntry) == 24
+                  && sizeof(IndexFooter) == 24, "File format must not change");
+}
+
+/**
+ * @brief Random access reader of block compressed log files
+ *
+ * @details Frames are located through the index at the end of the file, or by walking the frame headers if the
+ * file has none, and each is decompressed on its own, so a reader can start anywhere in the log.
+ */
+class CXLOG_API CompressedLogReader
+{
+public:
+    /**
+     * @brief Opens a file and locates its frames
+     * @throws std::runtime_error if the file can't be read or is not a compressed log
+     */
+    explicit CompressedLogReader(const std::filesystem::path& path);
+
+    /**
+     * @return Codec the file has been written with
+     */
+    [[nodiscard]]
+    FileCompression Codec() const noexcept { return _codec; }
+
+    /**
+     * @return true if frames have been located through the index, false if by walking the file
+     */
+    [[nodiscard]]
+    bool Indexed() const noexcept { return _indexed; }
+
+    /**
+     * @return All frames of the file, ordered by offset
+     */
+    [[nodiscard]]
+    const std::vector<compressed_log::FrameEntry>& Frames() const noexcept { return _frames; }
+
+    /**
+     * @brief Decompresses a single frame
+     * @param frame Index into Frames()
+     * @return Whole lines of the frame
+     * @throws std::runtime_error if the frame is corrupt
+     */
+    [[nodiscard]]
+    std::string ReadFrame(std::size_t frame);
+
+    /**
+     * @return Whole uncompressed log
+     * @throws std::runtime_error if a frame is corrupt
+     */
+    [[nodiscard]]
+    std::string ReadAll();
+
+private:
+    std::ifstream _file;
+    FileCompression _codec {FileCompression::None};
+    bool _indexed {false};
+    std::vector<compressed_log::FrameEntry> _frames;
+};
+
+CXLOG_NAMESPACE_END
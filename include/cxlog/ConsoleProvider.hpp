@@ -2,6 +2,7 @@
 #include "cxlog/defs.hpp"
 #include "cxlog/ILogger.hpp"
 #include "cxlog/ILoggerProvider.hpp"
+#include "cxlog/PatternFormatter.hpp"
 
 #include <string>
 #include <map>
@@ -23,8 +24,10 @@ public:
      *
      * @param target ostream to write log messages to
      * @param minLevel minimum accepted log level messages
+     * @param pattern line layout (see @ref PatternFormatter)
      */
-    explicit ConsoleProvider(std::ostream& target, LogLevel minLevel = LogLevel::Trace);
+    explicit ConsoleProvider(std::ostream& target, LogLevel minLevel = LogLevel::Trace,
+                             std::string_view pattern = PatternFormatter::DefaultPattern);
 
     /**
      * Creates logger with given category name.
@@ -34,17 +37,28 @@ public:
      */
     std::shared_ptr<ILogger> GetLogger(const std::string& name) override;
 
+    /**
+     * Drops the logger of given category name; it keeps working for whoever still holds it.
+     */
+    void ReleaseLogger(const std::string& name) override;
+
     /**
      * @return Provider name
      */
     [[nodiscard]]
     std::string_view GetName() const override;
 
+    /**
+     * Flushes the target stream
+     */
+    std::future<void> Flush() override;
+
 private:
     std::map<std::string, std::shared_ptr<ILogger>> _loggers;
 
     std::ostream& _target;
     LogLevel _minLevel;
+    std::string _pattern;
 };
 
 CXLOG_NAMESPACE_END
\ No newline at end of file
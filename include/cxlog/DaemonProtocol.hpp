@@ -0,0 +1,120 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/LogLevel.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Wire format between DaemonProvider and cxlogd
+ *
+ * @details Every SOCK_SEQPACKET message is one batch: a BatchHeader followed by Count records, each a RecordHeader
+ * immediately followed by the category and message bytes. Integers are in host byte order, as both ends run on
+ * the same machine.
+ */
+namespace daemon_protocol
+{
+    static constexpr std::uint32_t Magic = 0x43584c44;     /**< "CXLD" */
+    static constexpr std::uint16_t Version = 1;
+    static constexpr std::size_t MaxBatchSize = 256 * 1024;    /**< Largest batch the daemon receives */
+
+    struct BatchHeader
+    {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t count;        /**< Number of records in the batch */
+    };
+
+    struct RecordHeader
+    {
+        std::int64_t timestamp;     /**< Microseconds since epoch */
+        std::uint64_t threadId;
+        std::uint32_t messageLength;
+        std::uint16_t categoryLength;
+        std::uint8_t level;
+        std::uint8_t reserved;
+    };
+
+    static_assert(sizeof(BatchHeader) == 8 && sizeof(RecordHeader) == 24, "Wire format must not change");
+
+    /**
+     * @brief Decoded record, viewing into the batch
+     */
+    struct Record
+    {
+        std::int64_t Timestamp;
+        std::uint64_t ThreadId;
+        LogLevel Level;
+        std::string_view Category;
+        std::string_view Message;
+    };
+
+    /**
+     * @brief Appends a record to a batch which has been started with BeginBatch()
+     */
+    inline void AppendRecord(std::string& batch, const RecordHeader& header, std::string_view category,
+                             std::string_view message)
+    {
+        batch.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        batch.append(category).append(message);
+
+        BatchHeader batchHeader;
+        std::memcpy(&batchHeader, batch.data(), sizeof(batchHeader));
+        ++batchHeader.count;
+        std::memcpy(batch.data(), &batchHeader, sizeof(batchHeader));
+    }
+
+    inline void BeginBatch(std::string& batch)
+    {
+        BatchHeader header { Magic, Version, 0 };
+        batch.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    /**
+     * @brief Calls fn(const Record&) for every record of a received batch
+     * @return false if the batch is malformed; records before the malformed one have been passed to fn
+     */
+    template<typename F>
+    bool ForEachRecord(std::string_view batch, F&& fn)
+    {
+        BatchHeader header;
+        if (batch.size() < sizeof(header))
+            return false;
+
+        std::memcpy(&header, batch.data(), sizeof(header));
+        if (header.magic != Magic || header.version != Version)
+            return false;
+        batch.remove_prefix(sizeof(header));
+
+        for (std::uint16_t i = 0; i < header.count; ++i)
+        {
+            RecordHeader record;
+            if (batch.size() < sizeof(record))
+                return false;
+
+            std::memcpy(&record, batch.data(), sizeof(record));
+            batch.remove_prefix(sizeof(record));
+
+            if (batch.size() < std::size_t(record.categoryLength) + record.messageLength
+                || record.level > static_cast<std::uint8_t>(LogLevel::Critical))
+                return false;
+
+            fn(Record {
+                record.timestamp,
+                record.threadId,
+                static_cast<LogLevel>(record.level),
+                batch.substr(0, record.categoryLength),
+                batch.substr(record.categoryLength, record.messageLength),
+            });
+            batch.remove_prefix(std::size_t(record.categoryLength) + record.messageLength);
+        }
+        return true;
+    }
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,83 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/ILoggerProvider.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * Daemon provider options.
+ */
+struct DaemonProviderOptions
+{
+    LogLevel minLevel = LogLevel::Trace;                /**< Minimum level of messages to be accepted by this provider */
+    std::string socketPath {"/tmp/cxlogd.sock"};        /**< Unix socket cxlogd listens on */
+    std::size_t batchSize {16 * 1024};                  /**< Batches are sent once they reach this many bytes; at most
+                                                             daemon_protocol::MaxBatchSize */
+    std::chrono::milliseconds flushInterval {50};       /**< Partially filled batches are sent after this time */
+};
+
+/**
+ * Daemon provider.
+ *
+ * @brief Sends records to the local cxlogd collector, which writes the streams of all processes on the host
+ * through a single file pipeline.
+ *
+ * @details Records are framed into batches (see @ref daemon_protocol) and every batch is sent as one SOCK_SEQPACKET
+ * message, so the daemon always receives whole batches. Sending never blocks: if the daemon is not running or its
+ * socket buffer is full, the batch is dropped and counted (see Dropped()); the connection is re-established in the
+ * background. Process id is taken from the socket peer credentials by the daemon.
+ */
+class CXLOG_API DaemonProvider : public ILoggerProvider
+{
+public:
+    explicit DaemonProvider(DaemonProviderOptions opt = {});
+    ~DaemonProvider() override;
+
+    /**
+     * Creates logger with given category name.
+     *
+     * @note Multiple calls with same category name returns the same instance.
+     */
+    std::shared_ptr<ILogger> GetLogger(const std::string& name) override;
+
+    /**
+     * Drops the logger of given category name; it keeps working for whoever still holds it.
+     */
+    void ReleaseLogger(const std::string& name) override;
+
+    /**
+     * @return Provider name
+     */
+    [[nodiscard]]
+    std::string_view GetName() const override;
+
+    /**
+     * Sends the pending batch
+     */
+    std::future<void> Flush() override;
+
+    /**
+     * Sends the pending batch and disconnects. Messages logged afterwards are discarded.
+     */
+    std::future<void> Shutdown(std::chrono::steady_clock::time_point deadline) override;
+
+    /**
+     * @return Number of records which could not be delivered to the daemon
+     */
+    [[nodiscard]]
+    std::uint64_t Dropped() const noexcept;
+
+private:
+    struct SharedData;
+    friend class DaemonLogger;
+
+    std::map<std::string, std::shared_ptr<ILogger>> _loggers;
+    std::shared_ptr<SharedData> _providerData;  /**< Shared data for all loggers created by this provider */
+};
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,38 @@
+#pragma once
+#include "cxlog/defs.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Set of bytes escaped by AppendEscaped()
+ */
+enum class EscapeMode
+{
+    Json,   /**< Contents of a JSON string: quote, backslash and control characters */
+    Text,   /**< Single line of text: control characters except tab, and DEL; backslashes are kept as they are */
+};
+
+/**
+ * @brief Finds the first byte of text which has to be escaped
+ *
+ * @details Text is scanned 32 or 16 bytes at a time with AVX2 or SSE2 where available (chosen at runtime), and byte
+ * by byte otherwise.
+ *
+ * @return Offset of the byte, text.size() if there is none
+ */
+CXLOG_API std::size_t FindEscape(std::string_view text, EscapeMode mode) noexcept;
+
+/**
+ * @brief Appends text to out with the bytes of the given set escaped
+ *
+ * @details Runs of bytes which don't need escaping are found with FindEscape() and appended in bulk, so a clean
+ * text costs a scan and a single copy. Escapes are `\"`, `\\`, `\n`, `\r`, `\t` and `\u00XX` for JSON and `\n`,
+ * `\r` and `\xXX` for text. Bytes of multibyte UTF-8 sequences are never escaped.
+ */
+CXLOG_API void AppendEscaped(std::string& out, std::string_view text, EscapeMode mode);
+
+CXLOG_NAMESPACE_END
@@ -1,7 +1,9 @@
 #pragma once
 #include "cxlog/defs.hpp"
+#include "cxlog/CompressedLog.hpp"
 #include "cxlog/ILoggerFactory.hpp"
 #include "cxlog/ILogger.hpp"
+#include "cxlog/PatternFormatter.hpp"
 
 #include <filesystem>
 #include <variant>
@@ -18,6 +20,28 @@ enum class FileSplitType {
     Daily,          /**< One log file for each day */
 };
 
+/**
+ * How FileProvider writes to the file
+ */
+enum class FileBackend {
+    Stream,         /**< Buffered std::ofstream */
+    IoUring,        /**< Buffers submitted through io_uring (Linux only). Falls back to Stream if io_uring is not
+                         available. Buffers are submitted with a non-waiting io_uring_enter(), or handed to a
+                         kernel polling thread with uringSqPoll. The logging thread still waits in the kernel when
+                         every buffer is in flight, on flush, and when completing a short or failed write with
+                         pwrite(). */
+};
+
+/**
+ * How hard FileProvider tries to get records at or above FileProviderOptions::durableLevel onto the disk
+ */
+enum class FileDurability {
+    None,           /**< Records are written as buffers fill up */
+    Flush,          /**< Records are handed to the kernel right away, so they survive a crash of the process */
+    GroupCommit,    /**< As Flush, then committed with an fdatasync shared by all records of the commit window, so
+                         they survive a power loss once committed (see FileProvider::WaitDurable()) */
+};
+
 /**
  * File provider options.
  *
@@ -29,12 +53,51 @@ struct FileProviderOptions
     FileSplitType splitType = FileSplitType::None;  /**< Options for file splitting */
     int messagesCount {-1};                         /**< Max number of messages to be logged per file. Doesn't have any
                                                           effect unless splitType == NumMessages. Must be positive. */
+    std::string pattern {PatternFormatter::DefaultPattern}; /**< Line layout (see @ref PatternFormatter) */
+    bool index {false};                             /**< Write a sidecar index next to every file (see @ref LogIndexEntry) */
+    std::size_t indexBlockSize {64 * 1024};         /**< Approximate number of bytes covered by one index entry */
+    bool shared {false};                            /**< Append to one file together with other processes
+                                                         (see @ref FileProvider). Can't be combined with index. */
+    std::size_t sharedBatchSize {0};                /**< In shared mode, whole lines are collected up to this many
+                                                         bytes before being written. 0 writes every line at once. */
+    FileBackend backend {FileBackend::Stream};      /**< How data is written. Can't be combined with shared mode. */
+    std::size_t uringBufferSize {64 * 1024};        /**< Size of each io_uring buffer */
+    unsigned uringBufferCount {8};                  /**< Number of io_uring buffers which may be in flight at once */
+    bool uringSync {false};                         /**< Link an fdatasync to every io_uring buffer write */
+    bool uringSqPoll {false};                       /**< Have a kernel thread poll for io_uring submissions where
+                                                         permitted. Saves a syscall per buffer at the cost of the
+                                                         thread spinning for a while after every burst. */
+    FileDurability durability {FileDurability::None};   /**< Durability of records at or above durableLevel */
+    LogLevel durableLevel {LogLevel::Error};        /**< Minimum level of records durability applies to */
+    std::chrono::microseconds groupCommitWindow {1000}; /**< Max time a commit waits for more records to share its
+                                                             fdatasync */
+    FileCompression compression {FileCompression::None};   /**< Compress files in independent frames (see
+                                                                 @ref CompressedLogReader). Can't be combined with
+                                                                 shared mode, index or the io_uring backend. */
+    std::size_t compressionFrameSize {256 * 1024};  /**< Uncompressed bytes per frame, rounded up to a whole line */
+    int compressionLevel {0};                       /**< Codec specific level, 0 for the codec's default */
 };
 
 /**
  * File provider.
  *
  * @brief Logs all messages to a new file located on the path specified by the constructor.
+ *
+ * @details In shared mode (POSIX only), all processes logging into the same directory append to "current.log"
+ * opened with O_APPEND, and every line (or batch of whole lines) is written with a single write() call, so lines
+ * of different processes never tear or interleave. This includes processes forked after the provider has been
+ * created. Rotation state lives in a small "cxlog.lock" file mapped by every process: the process which finds
+ * the file due renames it to a timestamped name under flock(), and the others reopen "current.log" once they see
+ * the rotation. Lines written concurrently with a rotation may still land at the end of the previous file.
+ * Batched lines should be flushed before forking, or both processes will write them. With
+ * FileDurability::GroupCommit, a forked process starts its own commit thread on its first durable record or
+ * WaitDurable().
+ *
+ * With compression, files are named "*.log.cxz" and lines are compressed in frames of compressionFrameSize bytes on
+ * a writer thread owned by the provider, so logging threads only copy lines into the current frame. Frames are
+ * independent of each other, and an index of all of them is appended when a file is closed or rotated, so readers
+ * can decompress any part of a file (see @ref CompressedLogReader). Flush() and durable records cut the current
+ * frame short.
  */
 class CXLOG_API FileProvider : public ILoggerProvider
 {
@@ -49,12 +112,47 @@ public:
      */
     std::shared_ptr<ILogger> GetLogger(const std::string& name) override;
 
+    /**
+     * Drops the logger of given category name; it keeps working for whoever still holds it.
+     */
+    void ReleaseLogger(const std::string& name) override;
+
     /**
      * @return Provider name
      */
     [[nodiscard]]
     std::string_view GetName() const override;
- 
+
+    /**
+     * Flushes buffered data into the current log file
+     */
+    std::future<void> Flush() override;
+
+    /**
+     * Flushes and closes the current log file. Messages logged afterwards are discarded.
+     */
+    std::future<void> Shutdown(std::chrono::steady_clock::time_point deadline) override;
+
+    /**
+     * Waits until all records at or above durableLevel logged so far are on disk.
+     *
+     * @return true once they are; false if the deadline has passed first
+     * @note Returns true right away unless durability is FileDurability::GroupCommit
+     */
+    bool WaitDurable(std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    /**
+     * @return Backend actually in use, which differs from the requested one after a fallback
+     */
+    [[nodiscard]]
+    FileBackend Backend() const noexcept;
+
+    /**
+     * @return Codec actually in use, which differs from the requested one if cxlog has been built without it
+     */
+    [[nodiscard]]
+    FileCompression Compression() const noexcept;
+
 private:
     struct SharedData;
     friend class FileLogger;
@@ -0,0 +1,215 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/LogLevel.hpp"
+#include "cxlog/MessageBuffer.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <ratio>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+CXLOG_NAMESPACE_BEGIN
+
+/** Buffer format arguments are rendered into; see formatter */
+using FormatBuffer = details::MessageBuffer;
+
+namespace details
+{
+    template<typename T, typename = void>
+    struct is_streamable : std::false_type {};
+
+    template<typename T>
+    struct is_streamable<T, std::void_t<decltype(std::declval<std::ostream&>() << std::declval<const T&>())>>
+        : std::true_type {};
+
+    /*
+     * Enum with an operator<< of its own. Function call syntax only finds non-member inserters, so the stream's
+     * integer inserters, which unscoped enums reach through promotion, are not considered; its character inserters
+     * are ambiguous for them. At worst, another inserter is found and the enum is streamed, which prints the same.
+     */
+    template<typename T, typename = void>
+    struct is_custom_streamable_enum : std::false_type {};
+
+    template<typename T>
+    struct is_custom_streamable_enum<T, std::void_t<decltype(operator<<(std::declval<std::ostream&>(), std::declval<const T&>()))>>
+        : std::true_type {};
+
+    template<typename T>
+    void AppendInteger(FormatBuffer& out, T value, int base = 10)
+    {
+        char digits[sizeof(T) * 8 + 2];
+        auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value, base);
+        out.append(digits, static_cast<std::size_t>(end - digits));
+    }
+
+    template<typename T>
+    void AppendFloat(FormatBuffer& out, T value)
+    {
+        /* Precision of a default constructed ostream, so that switching from streams doesn't change any output */
+        char digits[64];
+#if defined(__cpp_lib_to_chars)
+        auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value, std::chars_format::general, 6);
+        out.append(digits, ec == std::errc() ? static_cast<std::size_t>(end - digits) : 0);
+#else
+        auto n = std::snprintf(digits, sizeof(digits), "%.6Lg", static_cast<long double>(value));
+        out.append(digits, n > 0 ? static_cast<std::size_t>(n) : 0);
+#endif
+    }
+
+    template<typename Ratio>
+    constexpr std::string_view DurationSuffix() noexcept
+    {
+        if constexpr (std::is_same_v<Ratio, std::nano>) return "ns";
+        else if constexpr (std::is_same_v<Ratio, std::micro>) return "us";
+        else if constexpr (std::is_same_v<Ratio, std::milli>) return "ms";
+        else if constexpr (std::is_same_v<Ratio, std::ratio<1>>) return "s";
+        else if constexpr (std::is_same_v<Ratio, std::ratio<60>>) return "min";
+        else if constexpr (std::is_same_v<Ratio, std::ratio<3600>>) return "h";
+        else return {};
+    }
+}
+
+/**
+ * @brief Renders a format argument of type T into a FormatBuffer
+ *
+ * @details Customization point of message formatting (see ILogger::Log()). Specializations provide
+ * `static void Format(FormatBuffer& out, const T& value)`, which appends the text of the value to the buffer, e.g.
+ *
+ * @code
+ * template<> struct cxlog::formatter<Point>
+ * {
+ *     static void Format(cxlog::FormatBuffer& out, const Point& p)
+ *     {
+ *         cxlog::formatter<int>::Format(out, p.x);
+ *         out.push_back(',');
+ *         cxlog::formatter<int>::Format(out, p.y);
+ *     }
+ * };
+ * @endcode
+ *
+ * Built-in specializations write arithmetic types with std::to_chars, and strings, enums, durations and pointers
+ * directly, producing the same text a default constructed std::ostream would. Durations, which have no stream
+ * operator before C++20, are written as the count followed by the unit, e.g. "250ms". Enums are written as their
+ * underlying value, unless they have an operator<< of their own. Any other type is streamed through its operator<< into
+ * the buffer; the stream is only constructed for such types.
+ */
+template<typename T, typename Enable = void>
+struct formatter
+{
+    static_assert(details::is_streamable<T>::value, "cxlog::formatter: type has neither a formatter nor operator<<");
+
+    static void Format(FormatBuffer& out, const T& value)
+    {
+        details::MessageStreamBuf streamBuf(out);
+        std::ostream os(&streamBuf);
+        os << value;
+    }
+};
+
+template<typename T>
+struct formatter<T, std::enable_if_t<std::is_convertible_v<const T&, std::string_view> && !std::is_same_v<T, std::nullptr_t>>>
+{
+    static void Format(FormatBuffer& out, const T& value)
+    {
+        if constexpr (std::is_pointer_v<T>)
+        {
+            if (!value)
+            {
+                out.append("(null)");
+                return;
+            }
+        }
+        out.append(std::string_view(value));
+    }
+};
+
+template<>
+struct formatter<bool>
+{
+    static void Format(FormatBuffer& out, bool value) { out.push_back(value ? '1' : '0'); }
+};
+
+template<typename T>
+struct formatter<T, std::enable_if_t<std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>>>
+{
+    static void Format(FormatBuffer& out, T value) { out.push_back(static_cast<char>(value)); }
+};
+
+template<typename T>
+struct formatter<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>
+                                     && !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>>>
+{
+    static void Format(FormatBuffer& out, T value) { details::AppendInteger(out, value); }
+};
+
+template<typename T>
+struct formatter<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    static void Format(FormatBuffer& out, T value) { details::AppendFloat(out, value); }
+};
+
+template<typename T>
+struct formatter<T, std::enable_if_t<std::conjunction_v<std::is_enum<T>, std::negation<details::is_custom_streamable_enum<T>>>>>
+{
+    static void Format(FormatBuffer& out, T value)
+    {
+        formatter<std::underlying_type_t<T>>::Format(out, static_cast<std::underlying_type_t<T>>(value));
+    }
+};
+
+template<>
+struct formatter<LogLevel>
+{
+    static void Format(FormatBuffer& out, LogLevel value) { out.append(std::string_view(to_string(value))); }
+};
+
+template<typename T>
+struct formatter<T*, std::enable_if_t<!std::is_convertible_v<T*, std::string_view> && !std::is_function_v<T>
+                                      && !std::is_same_v<std::remove_cv_t<T>, signed char>
+                                      && !std::is_same_v<std::remove_cv_t<T>, unsigned char>>>
+{
+    static void Format(FormatBuffer& out, const T* value)
+    {
+        out.append("0x");
+        details::AppendInteger(out, reinterpret_cast<std::uintptr_t>(value), 16);
+    }
+};
+
+template<>
+struct formatter<std::nullptr_t>
+{
+    static void Format(FormatBuffer& out, std::nullptr_t) { out.append("nullptr"); }
+};
+
+template<typename Rep, typename Period>
+struct formatter<std::chrono::duration<Rep, Period>>
+{
+    static void Format(FormatBuffer& out, const std::chrono::duration<Rep, Period>& value)
+    {
+        formatter<Rep>::Format(out, value.count());
+
+        constexpr auto suffix = details::DurationSuffix<typename Period::type>();
+        if constexpr (!suffix.empty())
+        {
+            out.append(suffix);
+        }
+        else
+        {
+            out.push_back('[');
+            details::AppendInteger(out, static_cast<std::intmax_t>(Period::num));
+            if constexpr (Period::den != 1)
+            {
+                out.push_back('/');
+                details::AppendInteger(out, static_cast<std::intmax_t>(Period::den));
+            }
+            out.append("]s");
+        }
+    }
+};
+
+CXLOG_NAMESPACE_END
@@ -1,5 +1,6 @@
 #pragma once
 #include "cxlog/defs.hpp"
+#include "cxlog/CallSite.hpp"
 #include "cxlog/ILoggerFactory.hpp"
 
 #include <memory>
@@ -14,4 +15,33 @@ public:
     ~GLogInitializer();
 } gLogInitializer;
 
-CXLOG_NAMESPACE_END
\ No newline at end of file
+CXLOG_NAMESPACE_END
+
+/**
+ * @brief Logs through the global factory, e.g. `CXLOG_LOG(cxlog::LogLevel::Info, "net", "{} bytes", n)`
+ *
+ * @details The category logger is created on the first call of every call site and kept in a function-local
+ * static, so later calls neither look the category up in the factory nor lock it. The category is therefore
+ * evaluated only once per call site, and a replacement of gLogFactory has to happen before the first message is
+ * logged through the macros.
+ *
+ * Every statement also gets a constant CallSite describing it, which is registered before main() (see
+ * RegisteredCallSites()) and attached to the records it logs. Level and format therefore have to be constants.
+ */
+#define CXLOG_LOG(level, category, ...)                                                                             \
+    do {                                                                                                            \
+        static constexpr ::cxlog::details::SiteSource cxlogSiteSource {                                             \
+            level, __FILE__, __LINE__, __func__, CXLOG_DETAIL_FORMAT(__VA_ARGS__, 0) };                             \
+        static const std::shared_ptr<::cxlog::ILogger> cxlogSiteLogger = ::cxlog::gLogFactory->CreateLogger(category); \
+        ::cxlog::details::LogAtSite<&cxlogSiteSource>(*cxlogSiteLogger, __VA_ARGS__);                               \
+    } while (false)
+
+/* Format is the first of the variadic arguments; the extra argument keeps the rest non-empty */
+#define CXLOG_DETAIL_FORMAT(format, ...) format
+
+#define CXLOG_TRACE(category, ...) CXLOG_LOG(::cxlog::LogLevel::Trace, category, __VA_ARGS__)
+#define CXLOG_DEBUG(category, ...) CXLOG_LOG(::cxlog::LogLevel::Debug, category, __VA_ARGS__)
+#define CXLOG_INFO(category, ...) CXLOG_LOG(::cxlog::LogLevel::Info, category, __VA_ARGS__)
+#define CXLOG_WARNING(category, ...) CXLOG_LOG(::cxlog::LogLevel::Warning, category, __VA_ARGS__)
+#define CXLOG_ERROR(category, ...) CXLOG_LOG(::cxlog::LogLevel::Error, category, __VA_ARGS__)
+#define CXLOG_CRITICAL(category, ...) CXLOG_LOG(::cxlog::LogLevel::Critical, category, __VA_ARGS__)
@@ -1,42 +1,25 @@
 #pragma once
 #include "cxlog/defs.hpp"
-
+#include "cxlog/CallSite.hpp"
+#include "cxlog/Formatter.hpp"
+#include "cxlog/LogContext.hpp"
+#include "cxlog/LogLevel.hpp"
+#include "cxlog/LogRecord.hpp"
+#include "cxlog/MessageBuffer.hpp"
+
+#include <cstddef>
+#include <ostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <map>
+#include <type_traits>
 
-CXLOG_NAMESPACE_BEGIN
-
-/**
- * @brief Defines the severity of the log message
- *e
- * @details Log levels are ordered from low to critical (Trace < Debug < Info < Warning < Error < Critical).
- * From logger standpoint, there is no differentiating between levels. It is up to the ILogger instances to decide
- * what to do with the message based on the level.
- */
-enum class LogLevel
-{
-    Trace,    /**< Trace messages help understand how the application code is executed */
-    Debug,    /**< The debug log captures relevant detail of events that may be useful during software debugging */
-    Info,     /**< This log level captures an event that occurred, but it does not have to affect operations */
-    Warning,  /**< Indicates that an unexpected event has occurred in an application that may disrupt the process */
-    Error,    /**< At least one system component is inoperable and other functionality may be affected */
-    Critical  /**< A system component is inoperable which is causing a fatal error within the system. */
-};
+#if __has_include(<span>)
+#include <span>
+#endif
 
-static constexpr const char* to_string(LogLevel level) noexcept
-{
-    switch (level)
-    {
-        case LogLevel::Trace: return "Trace";
-        case LogLevel::Debug: return "Debug";
-        case LogLevel::Info: return "Info";
-        case LogLevel::Warning: return "Warning";
-        case LogLevel::Error: return "Error";
-        case LogLevel::Critical: return "Critical";
-    }
-    return "";
-}
+CXLOG_NAMESPACE_BEGIN
 
 namespace details
 {
@@ -46,6 +29,26 @@ namespace details
     template <template <class...> class Template, class... Args>
     struct is_specialization<Template<Args...>, Template> : std::true_type {};
 
+    /**
+     * @brief Renders a format argument through its formatter; callables are invoked and their result rendered instead
+     *
+     * @details Allows deferring expensive arguments, e.g. `[&]{ return obj.Dump(); }`, until the message is
+     * known to be logged.
+     */
+    template<typename T>
+    void AppendArg(FormatBuffer& out, T&& arg)
+    {
+        if constexpr (std::is_invocable_v<T&>)
+        {
+            const auto& result = arg();
+            formatter<std::decay_t<decltype(result)>>::Format(out, result);
+        }
+        else
+        {
+            formatter<std::decay_t<T>>::Format(out, arg);
+        }
+    }
+
     struct Props
     {
         std::map<std::string, std::string> mapped;
@@ -59,10 +62,13 @@ namespace details
         template<typename T, typename...Args>
         void expo(T&& value, Args&&...others)
         {
-            std::stringstream ss;
-            ss << value.second;
+            {
+                ArenaScope scope;
+                MessageBuffer buffer;
+                AppendArg(buffer, value.second);
 
-            mapped[value.first] = ss.str();
+                mapped[value.first] = std::string(buffer.view());
+            }
             expo(std::forward<Args>(others)...);
         }
 
@@ -88,9 +94,35 @@ public:
      * @brief Log a message
      *
      * @param level Severity level (see /ref LogLevel)
-     * @param message Message content
+     * @param message Message content, only valid for the duration of the call
+     */
+    virtual void Log(LogLevel level, std::string_view message) = 0;
+
+    /**
+     * @brief Log a record
+     *
+     * @details Record based entry point used by the factory loggers, so that all providers share a single record
+     * (and its rendered line) per message. Default implementation forwards the message to Log(level, message).
+     *
+     * @param record Log record (see /ref LogRecord)
+     */
+    virtual void Log(const LogRecord& record)
+    {
+        Log(record.Level, record.Message);
+    }
+
+    /**
+     * @brief Log a message of a known statement
+     *
+     * @details Default implementation drops the site and forwards the message to Log(level, message).
+     *
+     * @param site Statement the message was logged from (see /ref CallSite)
+     * @param message Message content, only valid for the duration of the call
      */
-    virtual void Log(LogLevel level, const std::string& message) = 0;
+    virtual void Log(const CallSite& site, std::string_view message)
+    {
+        Log(site.Level, message);
+    }
 
     /**
      * @brief Check if a given log level is enabled for this logger.
@@ -101,41 +133,118 @@ public:
     [[nodiscard]]
     virtual bool IsEnabled(LogLevel level) const noexcept = 0;
 
+    /**
+     * @brief Estimates memory held by this logger
+     *
+     * @details Size of the object along with what it has allocated, excluding state shared with other loggers.
+     * Used by LoggerFactory::GetMemoryUsage(). Default implementation reports nothing.
+     *
+     * @return Bytes held
+     */
+    [[nodiscard]]
+    virtual std::size_t MemoryUsage() const noexcept
+    {
+        return 0;
+    }
+
     /* ~~~~~~~~~~~~~~~~~~~~ Helpers - non overridable functions ~~~~~~~~~~~~~~~~~~~~ */
 
+    /**
+     * @brief Log a message built from the format, replacing each "{}" with the next argument
+     *
+     * @details Message is built in an inline buffer on the stack and passed on as a view, so messages shorter than
+     * details::MessageBuffer::InlineSize don't allocate. Longer ones use the thread's message arena, which is reset
+     * once the message has been dispatched. Arguments are rendered by their formatter (see formatter), which only
+     * falls back to a stream for types providing nothing but operator<<.
+     *
+     * Nothing is formatted if the level is not enabled. Callable arguments are invoked only after that check, so
+     * expensive diagnostics can be passed as lambdas, e.g. `[&]{ return state.Dump(); }`, and cost nothing while
+     * disabled.
+     */
     template<typename... Args>
-    void Log(LogLevel level, std::string format, Args&& ...args)
+    void Log(LogLevel level, std::string_view format, Args&& ...args)
     {
-        ([&, idx = 0ul](auto&& arg) mutable {
-            idx = format.find("{}", idx);
-            if (idx == std::string::npos)
+        if (!IsEnabled(level))
+            return;
+
+        details::ArenaScope scope;
+        details::MessageBuffer buffer;
+
+        std::size_t pos = 0;
+        ([&](auto&& arg) {
+            auto idx = format.find("{}", pos);
+            if (idx == std::string_view::npos)
                 return;
 
-            std::stringstream ss;
-            ss << arg;
+            buffer.append(format.substr(pos, idx - pos));
+            details::AppendArg(buffer, std::forward<decltype(arg)>(arg));
+            pos = idx + 2;
+        }(std::forward<Args>(args)), ...);
+
+        buffer.append(format.substr(pos));
+        Log(level, buffer.view());
+    }
+
+    /**
+     * @brief Log a message of a known statement, built from the site's format and the arguments
+     *
+     * @details Same as Log(level, format, args...), except that level and format are taken from the site and the
+     * placeholders are located from the offsets recorded in the site rather than by searching the format. The site's
+     * mode is checked first; enabled sites are logged even if IsEnabled() would reject their level.
+     */
+    template<typename... Args>
+    void LogAt(const CallSite& site, Args&& ...args)
+    {
+        auto mode = site.Mode ? site.Mode->load(std::memory_order_relaxed) : SiteMode::Default;
+        if (mode == SiteMode::Disabled || (mode == SiteMode::Default && !IsEnabled(site.Level)))
+            return;
+
+        details::ArenaScope scope;
+        details::MessageBuffer buffer;
+
+        std::size_t pos = 0;
+        [[maybe_unused]] std::uint32_t index = 0;    /* Unused without arguments */
+        ([&](auto&& arg) {
+            auto idx = index < site.ArgCount ? site.ArgOffsets[index++] : site.Format.size();
+            if (idx >= site.Format.size())
+                return;
 
-            format.replace(idx, 2, ss.str());
+            buffer.append(site.Format.substr(pos, idx - pos));
+            details::AppendArg(buffer, std::forward<decltype(arg)>(arg));
+            pos = idx + 2;
         }(std::forward<Args>(args)), ...);
 
-        Log(level, format);
+        buffer.append(site.Format.substr(pos));
+        Log(site, buffer.view());
     }
 
-    template<typename... Args> inline void LogTrace(const std::string& message, Args&& ...args)
+    /**
+     * @brief Log raw bytes as the message content
+     */
+    inline void Log(LogLevel level, const std::byte* data, std::size_t size)
+    { Log(level, std::string_view(reinterpret_cast<const char*>(data), size)); }
+
+#if defined(__cpp_lib_span)
+    inline void Log(LogLevel level, std::span<const std::byte> bytes)
+    { Log(level, bytes.data(), bytes.size()); }
+#endif
+
+    template<typename... Args> inline void LogTrace(std::string_view message, Args&& ...args)
     { Log(LogLevel::Trace, message, std::forward<Args>(args)...); }
 
-    template<typename... Args> inline void LogDebug(const std::string& message, Args&& ...args)
+    template<typename... Args> inline void LogDebug(std::string_view message, Args&& ...args)
     { Log(LogLevel::Debug, message, std::forward<Args>(args)...); }
 
-    template<typename... Args> inline void LogInfo(const std::string& message, Args&& ...args)
+    template<typename... Args> inline void LogInfo(std::string_view message, Args&& ...args)
     { Log(LogLevel::Info, message, std::forward<Args>(args)...); }
 
-    template<typename... Args> inline void LogWarning(const std::string& message, Args&& ...args)
+    template<typename... Args> inline void LogWarning(std::string_view message, Args&& ...args)
     { Log(LogLevel::Warning, message, std::forward<Args>(args)...); }
 
-    template<typename... Args> inline void LogError(const std::string& message, Args&& ...args)
+    template<typename... Args> inline void LogError(std::string_view message, Args&& ...args)
     { Log(LogLevel::Error, message, std::forward<Args>(args)...); }
 
-    template<typename... Args> inline void LogCritical(const std::string& message, Args&& ...args)
+    template<typename... Args> inline void LogCritical(std::string_view message, Args&& ...args)
     { Log(LogLevel::Critical, message, std::forward<Args>(args)...); }
 };
 
@@ -38,6 +38,28 @@ public:
      * loggers created by this factory. However, the real effect of this function is implementation specific.
      */
     virtual ILoggerFactory& AddProvider(std::shared_ptr<ILoggerProvider> provider) = 0;
+
+    /**
+     * @brief Delivers all messages logged so far and flushes all providers
+     * @return Future which becomes ready once all providers have been flushed
+     *
+     * @details Useful to drain asynchronous and buffered providers, e.g. before calling fork().
+     */
+    virtual std::future<void> Flush()
+    {
+        return details::ReadyFuture();
+    }
+
+    /**
+     * @brief Delivers pending messages and shuts down all providers
+     * @param deadline Messages not delivered by this point in time are discarded
+     * @return Future which becomes ready once all providers have shut down
+     */
+    virtual std::future<void> Shutdown(std::chrono::steady_clock::time_point deadline)
+    {
+        (void)deadline;
+        return Flush();
+    }
 };
 
 CXLOG_NAMESPACE_END
\ No newline at end of file
@@ -2,12 +2,27 @@
 #include "cxlog/defs.hpp"
 #include "cxlog/ILogger.hpp"
 
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <string_view>
 
 CXLOG_NAMESPACE_BEGIN
 
+namespace details
+{
+    /**
+     * @return Future which is already satisfied
+     */
+    inline std::future<void> ReadyFuture()
+    {
+        std::promise<void> promise;
+        promise.set_value();
+        return promise.get_future();
+    }
+}
+
 /**
  * Interface for logger provider
  *
@@ -33,6 +48,42 @@ public:
      * @return
      */
     virtual std::shared_ptr<ILogger> GetLogger(const std::string& name) = 0;
+
+    /**
+     * @brief Drops the provider's reference to the logger of a category
+     * @param name Category name for the logger
+     *
+     * @details Called by LoggerFactory when it evicts the category. The logger keeps working for as long as anyone
+     * still holds it; a later GetLogger() may return a new instance. Default implementation does nothing.
+     */
+    virtual void ReleaseLogger(const std::string& name)
+    {
+        (void)name;
+    }
+
+    /**
+     * @brief Writes out any data buffered by this provider
+     * @return Future which becomes ready once buffered data has been handed over to the underlying sink
+     *
+     * @details Default implementation has nothing to flush and returns a ready future.
+     */
+    virtual std::future<void> Flush()
+    {
+        return details::ReadyFuture();
+    }
+
+    /**
+     * @brief Flushes buffered data and releases the sink; messages logged afterwards are discarded
+     * @param deadline Point in time by which the provider should give up on pending data
+     * @return Future which becomes ready once the provider has shut down
+     *
+     * @details Default implementation only flushes.
+     */
+    virtual std::future<void> Shutdown(std::chrono::steady_clock::time_point deadline)
+    {
+        (void)deadline;
+        return Flush();
+    }
 };
 
 CXLOG_NAMESPACE_END
\ No newline at end of file
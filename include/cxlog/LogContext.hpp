@@ -0,0 +1,143 @@
+#pragma once
+#include "cxlog/defs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+CXLOG_NAMESPACE_BEGIN
+
+namespace details
+{
+    /** Separates key from value within a packed context field */
+    constexpr char ContextKeySeparator = '\x1f';
+
+    /** Terminates each packed context field */
+    constexpr char ContextFieldSeparator = '\x1e';
+
+    /**
+     * @return Packed context fields of the calling thread, valid until the context changes
+     */
+    CXLOG_API std::string_view CurrentContext() noexcept;
+
+    /**
+     * @brief Calls fn(key, value) for every field of a packed context, outermost first
+     */
+    template<typename F>
+    void ForEachContextField(std::string_view context, F&& fn)
+    {
+        while (!context.empty())
+        {
+            auto end = context.find(ContextFieldSeparator);
+            auto field = context.substr(0, end);
+            auto sep = field.find(ContextKeySeparator);
+
+            fn(field.substr(0, sep), sep == std::string_view::npos ? std::string_view() : field.substr(sep + 1));
+
+            if (end == std::string_view::npos)
+                break;
+            context.remove_prefix(end + 1);
+        }
+    }
+
+    /**
+     * @brief Looks up a field of a packed context; inner scopes shadow outer ones
+     * @return true if found
+     */
+    CXLOG_API bool FindContextField(std::string_view context, std::string_view key, std::string_view& value) noexcept;
+
+    /* Stream buffer writing into a fixed array, silently truncating */
+    class FixedStreamBuf : public std::streambuf
+    {
+    public:
+        FixedStreamBuf(char* data, std::size_t size) { setp(data, data + size); }
+
+        [[nodiscard]]
+        std::size_t size() const noexcept { return static_cast<std::size_t>(pptr() - pbase()); }
+    };
+}
+
+/**
+ * @brief Single key/value pair of a diagnostic context
+ *
+ * @details Strings are referenced, numbers and other streamable values are rendered into a small inline buffer
+ * (longer representations are truncated). Fields are only meant to be passed to ScopedContext, which copies them.
+ */
+class CXLOG_API ContextField
+{
+public:
+    static constexpr std::size_t InlineSize = 64;
+
+    template<typename T>
+    ContextField(std::string_view key, const T& value) : _key(key)
+    {
+        if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            _value = value;
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            _value = value ? "true" : "false";
+        }
+        else
+        {
+            details::FixedStreamBuf buf(_inline, InlineSize);
+            std::ostream os(&buf);
+            os << value;
+            _inlineSize = static_cast<std::uint8_t>(buf.size());
+            _isInline = true;
+        }
+    }
+
+    template<typename K, typename T>
+    ContextField(const std::pair<K, T>& pair) : ContextField(pair.first, pair.second) {} // NOLINT(*-explicit-constructor)
+
+    [[nodiscard]]
+    std::string_view Key() const noexcept { return _key; }
+
+    [[nodiscard]]
+    std::string_view Value() const noexcept { return _isInline ? std::string_view(_inline, _inlineSize) : _value; }
+
+private:
+    std::string_view _key;
+    std::string_view _value;
+    char _inline[InlineSize];
+    std::uint8_t _inlineSize {0};
+    bool _isInline {false};
+};
+
+/**
+ * @brief Pushes fields onto the calling thread's diagnostic context for the lifetime of the scope
+ *
+ * @details Fields are copied into a fixed per-thread buffer (see ScopedContext::Capacity), so entering a scope does
+ * not allocate; fields which don't fit are dropped. Records capture the context by reference when created and copy
+ * it only when they have to outlive the call, e.g. for asynchronous dispatch. It is rendered by providers through
+ * the %X pattern field, so the context is only formatted for records which pass all filters.
+ *
+ * @code
+ * cxlog::ScopedContext ctx{{"req", requestId}, {"tenant", tenant}};
+ * logger->LogInfo("accepted");     // "%X %v" renders as "req=42 tenant=acme accepted"
+ * @endcode
+ */
+class CXLOG_API ScopedContext
+{
+public:
+    /** Size of the per-thread buffer holding all fields of nested scopes */
+    static constexpr std::size_t Capacity = 1024;
+
+    ScopedContext(std::initializer_list<ContextField> fields) noexcept;
+    ~ScopedContext();
+
+    ScopedContext(const ScopedContext&) = delete;
+    ScopedContext& operator=(const ScopedContext&) = delete;
+
+private:
+    std::size_t _previousSize;
+};
+
+CXLOG_NAMESPACE_END
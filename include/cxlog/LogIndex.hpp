@@ -0,0 +1,83 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/LogLevel.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Summary of one block of a log segment, as stored in the sidecar index
+ *
+ * @details FileProvider with FileProviderOptions::index enabled writes "<segment>.idx" next to every log segment. The
+ * index is a short header (LogIndexEntry::Magic) followed by one fixed size entry per block of roughly
+ * FileProviderOptions::indexBlockSize bytes. Blocks always start at a line boundary. Entries are stored in host byte
+ * order and appended as blocks are completed, so an index lags behind its segment by at most one block until the
+ * provider is flushed.
+ *
+ * Each entry is a sparse time to offset checkpoint, extended by the set of levels and a bloom filter of categories
+ * found in the block, which lets readers skip blocks which can't contain matching lines without touching them.
+ */
+struct CXLOG_API LogIndexEntry
+{
+    static constexpr char Magic[8] = { 'C', 'X', 'L', 'I', 'D', 'X', '1', '\0' };
+
+    std::uint64_t Offset {0};                  /**< Offset of the block in the segment */
+    std::uint64_t Length {0};                  /**< Length of the block in bytes */
+    std::int64_t MinTime {0};                  /**< Earliest timestamp of the block's lines, microseconds since epoch */
+    std::int64_t MaxTime {0};                  /**< Latest timestamp of the block's lines, microseconds since epoch */
+    std::uint32_t Levels {0};                  /**< Bit (1 << level) set for every level present in the block */
+    std::uint32_t Lines {0};                   /**< Number of lines in the block */
+    std::array<std::uint64_t, 4> Categories {};/**< 256 bit bloom filter of category names */
+
+    /**
+     * @brief Accounts for a line appended to the block
+     * @param bloom Category bits, see CategoryBloom()
+     */
+    void Add(LogLevel level, std::chrono::system_clock::time_point timestamp, const std::array<std::uint64_t, 4>& bloom,
+             std::size_t length) noexcept;
+
+    /**
+     * @return Bloom filter bits of a category name
+     */
+    static std::array<std::uint64_t, 4> CategoryBloom(std::string_view category) noexcept;
+};
+
+/**
+ * @brief Block selection criteria; unset members match everything
+ */
+struct CXLOG_API LogIndexFilter
+{
+    std::optional<std::chrono::system_clock::time_point> From;   /**< Earliest timestamp of interest */
+    std::optional<std::chrono::system_clock::time_point> To;     /**< Latest timestamp of interest */
+    std::optional<LogLevel> MinLevel;                            /**< Least severe level of interest */
+    std::optional<std::string> Category;                         /**< Category of interest */
+
+    /**
+     * @return false if the block certainly has no matching line, true if it may have some
+     */
+    [[nodiscard]]
+    bool MayMatch(const LogIndexEntry& entry) const noexcept;
+};
+
+/**
+ * @brief Reads the sidecar index of a segment
+ * @param index Path of the index file
+ * @return Index entries ordered by offset
+ * @throws std::runtime_error if the file can't be read or is not an index
+ */
+CXLOG_API std::vector<LogIndexEntry> ReadLogIndex(const std::filesystem::path& index);
+
+/**
+ * @return Path of the sidecar index belonging to a segment
+ */
+CXLOG_API std::filesystem::path LogIndexPath(const std::filesystem::path& segment);
+
+CXLOG_NAMESPACE_END
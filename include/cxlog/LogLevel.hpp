@@ -0,0 +1,37 @@
+#pragma once
+#include "cxlog/defs.hpp"
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Defines the severity of the log message
+ *e
+ * @details Log levels are ordered from low to critical (Trace < Debug < Info < Warning < Error < Critical).
+ * From logger standpoint, there is no differentiating between levels. It is up to the ILogger instances to decide
+ * what to do with the message based on the level.
+ */
+enum class LogLevel
+{
+    Trace,    /**< Trace messages help understand how the application code is executed */
+    Debug,    /**< The debug log captures relevant detail of events that may be useful during software debugging */
+    Info,     /**< This log level captures an event that occurred, but it does not have to affect operations */
+    Warning,  /**< Indicates that an unexpected event has occurred in an application that may disrupt the process */
+    Error,    /**< At least one system component is inoperable and other functionality may be affected */
+    Critical  /**< A system component is inoperable which is causing a fatal error within the system. */
+};
+
+static constexpr const char* to_string(LogLevel level) noexcept
+{
+    switch (level)
+    {
+        case LogLevel::Trace: return "Trace";
+        case LogLevel::Debug: return "Debug";
+        case LogLevel::Info: return "Info";
+        case LogLevel::Warning: return "Warning";
+        case LogLevel::Error: return "Error";
+        case LogLevel::Critical: return "Critical";
+    }
+    return "";
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,86 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/LogLevel.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+CXLOG_NAMESPACE_BEGIN
+
+struct CallSite;
+class PatternFormatter;
+
+/**
+ * @brief Single log event, created once per message and passed to all providers
+ *
+ * @details Record is created by the logger at the call site and carries everything providers need to render a line.
+ * Message and category are views; the message is either borrowed from the caller for the duration of a synchronous
+ * dispatch, or kept in the refcounted Storage once the record has to outlive the call (see Own()). Category is owned
+ * by the logger which created the record.
+ *
+ * Context refers to the fields of the ScopedContext active on the creating thread, and follows the same rules as
+ * the message.
+ *
+ * Providers using the same line layout share the rendered bytes through Render(), so a message is formatted once
+ * per layout rather than once per provider.
+ */
+struct CXLOG_API LogRecord
+{
+    LogLevel Level { LogLevel::Trace };                    /**< Severity of the message */
+    std::uint32_t CategoryId {0};                          /**< Id assigned to the category by the factory, 0 if none */
+    std::string_view Category;                             /**< Category name */
+    std::chrono::system_clock::time_point Timestamp;       /**< Time the message was logged */
+    std::uint64_t ThreadId {0};                            /**< Id of the thread which logged the message */
+    std::uint32_t ProcessId {0};                           /**< Id of the process which logged the message */
+    std::string_view Message;                              /**< Message content */
+    std::string_view Context;                              /**< Packed diagnostic context (see ScopedContext) */
+    std::shared_ptr<const std::string> Storage;            /**< Owned message and context, if any */
+    std::chrono::steady_clock::time_point SpanStart;       /**< Start of a span (see Span), epoch for plain messages */
+    std::chrono::nanoseconds SpanDuration {0};             /**< Duration of a span */
+    const CallSite* Site {nullptr};                        /**< Statement the message was logged from, if known */
+
+    /**
+     * @brief Creates a record stamped with the current time, thread, process and diagnostic context
+     */
+    static LogRecord Make(LogLevel level, std::string_view category, std::string_view message, std::uint32_t categoryId = 0);
+
+    /**
+     * @return true if the record marks the end of a Span, in which case Message is the span name
+     */
+    [[nodiscard]]
+    bool IsSpan() const noexcept { return SpanStart != std::chrono::steady_clock::time_point{}; }
+
+    /**
+     * @brief Copies the message and context into the refcounted Storage, unless already there
+     * @return self
+     */
+    LogRecord& Own();
+
+    /**
+     * @brief Renders the record with given layout, reusing bytes rendered for an identical layout
+     * @param formatter Line layout
+     * @return Rendered line, valid until the next Render() of any record on the same thread
+     */
+    [[nodiscard]]
+    std::string_view Render(const PatternFormatter& formatter) const;
+
+    /**
+     * @return Numeric id of the calling thread (OS thread id where available)
+     */
+    static std::uint64_t CurrentThreadId() noexcept;
+
+    /**
+     * @return Id of the current process
+     */
+    static std::uint32_t CurrentProcessId() noexcept;
+
+private:
+    mutable const void* _renderedBuffer {nullptr};         /**< Thread local buffer holding the rendered line */
+    mutable std::uint64_t _renderedGeneration {0};         /**< Generation of the buffer when rendered */
+    mutable const void* _renderedLayout {nullptr};         /**< Layout the line was rendered with */
+};
+
+CXLOG_NAMESPACE_END
@@ -7,8 +7,11 @@
 #include <string_view>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <functional>
 #include <optional>
+#include <chrono>
+#include <cstdint>
 
 CXLOG_NAMESPACE_BEGIN
 
@@ -27,21 +30,97 @@ struct LoggerRule
     std::function<bool(std::string_view provider, std::string_view category, LogLevel level)> Filter;
 };
 
+/**
+ * @brief Behaviour of the asynchronous queue when the sink can't keep up
+ */
+enum class OverflowPolicy
+{
+    Block,          /**< Caller waits up to BlockTimeout for a free slot, then the record is dropped */
+    DropNewest,     /**< Incoming record is discarded */
+    DropOldest,     /**< Oldest queued record is discarded to make room for the incoming one */
+    DropBelowLevel, /**< Incoming records below DropLevel are discarded, others are handled as with Block */
+};
+
+/**
+ * @brief How records are handed over to the providers when dispatching asynchronously
+ */
+enum class DispatchMode
+{
+    Shared,         /**< Single queue and consumer thread feeding all providers one after another */
+    PerProvider,    /**< Each provider has its own queue and consumer thread, so a slow sink never delays others */
+    Sharded,        /**< Every producing thread has its own ring of Capacity records, and a single consumer thread
+                         merges them in timestamp order, so producers never contend with each other */
+};
+
+/**
+ * @brief Asynchronous dispatch options
+ *
+ * @details When set, loggers created by the factory only enqueue messages and a background thread forwards them
+ * to the providers. Records at or above PriorityLevel travel through a separate lane, which is always drained first,
+ * so they are never queued behind a flood of less severe messages. The priority lane always blocks when full.
+ *
+ * With DispatchMode::PerProvider, every provider gets its own queue configured by these options. Each queue sheds
+ * load according to the policy on its own, so a stalled sink only drops its own records.
+ */
+struct AsyncOptions
+{
+    std::size_t Capacity { 8192 };                    /**< Max number of queued records in the normal lane */
+    OverflowPolicy Policy { OverflowPolicy::Block };  /**< What to do when the normal lane is full */
+    std::chrono::milliseconds BlockTimeout { 100 };   /**< Max time a caller may block waiting for a free slot */
+    LogLevel DropLevel { LogLevel::Warning };         /**< Threshold for OverflowPolicy::DropBelowLevel */
+    LogLevel PriorityLevel { LogLevel::Error };       /**< Records at or above this level use the priority lane */
+    std::size_t PriorityCapacity { 1024 };            /**< Max number of queued records in the priority lane */
+    DispatchMode Mode { DispatchMode::Shared };       /**< Single queue for all providers or one per provider */
+};
+
+/**
+ * @brief Counters reported by the asynchronous queue
+ */
+struct AsyncStats
+{
+    std::uint64_t Enqueued {0};           /**< Records accepted into either lane */
+    std::uint64_t Dispatched {0};         /**< Records forwarded to the providers */
+    std::uint64_t DroppedNewest {0};      /**< Records discarded by OverflowPolicy::DropNewest */
+    std::uint64_t DroppedOldest {0};      /**< Records evicted by OverflowPolicy::DropOldest */
+    std::uint64_t DroppedBelowLevel {0};  /**< Records discarded by OverflowPolicy::DropBelowLevel */
+    std::uint64_t DroppedTimeout {0};     /**< Records discarded after blocking for BlockTimeout */
+    std::uint64_t Discarded {0};          /**< Records still queued past the Shutdown() deadline */
+};
+
 /**
  * Logger factory options
  */
 struct LoggerOptions
 {
     LogLevel MinLevel { LogLevel::Trace };
-    std::vector<LoggerRule> Rules;
+    std::vector<LoggerRule> Rules {};
+    std::optional<AsyncOptions> Async {}; /**< Enables asynchronous dispatch when set */
+    std::size_t MaxLoggers {0};           /**< Max number of cached categories, 0 for no limit. Least recently used
+                                               ones are evicted once exceeded, down to 7/8 of the limit. */
+    std::chrono::milliseconds IdleTimeout {0};  /**< Categories not used for this long are evicted, 0 never */
+};
+
+/**
+ * @brief Memory held for a category, see LoggerFactory::GetMemoryUsage()
+ */
+struct CategoryMemory
+{
+    std::string Category;
+    std::size_t Bytes {0};              /**< Factory logger and the loggers of all providers */
+    bool Cached {true};                 /**< False once evicted, while the logger is still held elsewhere */
 };
 
 class Logger;
+struct AsyncRecord;
+struct ProviderRecord;
+template<typename T> class IAsyncQueue;
+
 class CXLOG_API LoggerFactory : public ILoggerFactory
 {
 public:
     LoggerFactory();
     explicit LoggerFactory(const std::vector<std::shared_ptr<ILoggerProvider>>& providers, LoggerOptions options = {});
+    ~LoggerFactory() override;
 
     /**
      * @brief Create a logger with given category name
@@ -69,14 +148,78 @@ public:
      */
     ILoggerFactory& AddProvider(std::shared_ptr<ILoggerProvider> provider) override;
 
+    /**
+     * @brief Delivers all messages logged so far and flushes all providers
+     * @return Future which becomes ready once all providers have been flushed
+     *
+     * @details With asynchronous dispatch, providers are flushed on their consumer thread once everything queued
+     * before this call has been handed over to them.
+     */
+    std::future<void> Flush() override;
+
+    /**
+     * @brief Delivers pending messages and shuts down all providers
+     * @param deadline Queued messages the consumer gets to after this point in time are discarded
+     * @return Future which becomes ready once all providers have shut down
+     */
+    std::future<void> Shutdown(std::chrono::steady_clock::time_point deadline) override;
+
+    /**
+     * @brief Returns queue counters of asynchronous dispatch
+     * @return Counters summed over all queues, all zero if asynchronous dispatch is not enabled
+     */
+    [[nodiscard]]
+    AsyncStats GetAsyncStats() const noexcept;
+
+    /**
+     * @brief Returns queue counters of a single provider when dispatching with DispatchMode::PerProvider
+     * @param providerName Name of the provider (see ILoggerProvider::GetName)
+     * @return Counters of the provider's queue, all zero if there is no such queue
+     */
+    [[nodiscard]]
+    AsyncStats GetAsyncStats(std::string_view providerName) const noexcept;
+
+    /**
+     * @brief Evicts categories idle for longer than LoggerOptions::IdleTimeout
+     * @return Number of categories evicted
+     *
+     * @details Runs on its own whenever a logger is created, at most once per IdleTimeout. Evicted categories are
+     * released by all providers, and only remain referenced weakly by the factory; loggers still held elsewhere keep
+     * working, and CreateLogger() returns them again for as long as they are alive.
+     */
+    std::size_t EvictIdleLoggers();
+
+    /**
+     * @brief Estimates memory held per category
+     * @return Categories known to the factory, including evicted ones still held elsewhere, in name order
+     */
+    [[nodiscard]]
+    std::vector<CategoryMemory> GetMemoryUsage() const;
+
 protected:
     [[nodiscard]]
     const LoggerRule* ApplyFilters(std::string_view Provider, std::string_view Category) const noexcept;
 
 private:
+    std::weak_ptr<IAsyncQueue<ProviderRecord>> GetProviderQueue(const ILoggerProvider* provider);
+    std::future<void> ForEachProvider(const std::function<std::future<void>(ILoggerProvider&)>& action);
+    std::size_t Evict(std::size_t keep, std::chrono::steady_clock::time_point idleSince);
+
+    struct CachedLogger
+    {
+        std::shared_ptr<Logger> Strong;     /**< Set while cached */
+        std::weak_ptr<Logger> Weak;         /**< Evicted logger, which may still be held elsewhere */
+    };
+
+    mutable std::mutex _mutex;  /**< Guards providers and loggers, so that loggers can be created from any thread */
     std::vector<std::shared_ptr<ILoggerProvider>> _providers;
-    std::map<std::string, std::shared_ptr<Logger>> _loggers;
+    std::map<std::string, CachedLogger, std::less<>> _loggers;
+    std::size_t _cached {0};                /**< Entries of _loggers holding a strong reference */
+    std::chrono::steady_clock::time_point _lastSweep;   /**< Last eviction of idle categories */
     LoggerOptions _options;
+    std::shared_ptr<IAsyncQueue<AsyncRecord>> _queue;
+    std::map<const ILoggerProvider*, std::shared_ptr<IAsyncQueue<ProviderRecord>>> _providerQueues;
+    std::uint32_t _nextCategoryId {0};
 };
 
 CXLOG_NAMESPACE_END
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "cxlog/defs.hpp"
 #include "cxlog/ILoggerProvider.hpp"
+#include "cxlog/PatternFormatter.hpp"
 
 #include <deque>
 #include <vector>
@@ -14,8 +15,11 @@ public:
     /**
      * @brief Constructor
      * @param numLines Number of lines of logs to keep in memory
+     * @param minLevel Minimum accepted log level messages
+     * @param pattern Line layout (see @ref PatternFormatter)
      */
-    explicit MemoryProvider(int numLines, LogLevel minLevel = LogLevel::Trace);
+    explicit MemoryProvider(int numLines, LogLevel minLevel = LogLevel::Trace,
+                            std::string_view pattern = PatternFormatter::DefaultPattern);
 
     /**
      * @brief Forward saved log lines from the logger. Clears the log lines inside the provider
@@ -28,6 +32,11 @@ public:
 
     std::shared_ptr<ILogger> GetLogger(const std::string& name) override;
 
+    /**
+     * Drops the logger of given category name; it keeps working for whoever still holds it.
+     */
+    void ReleaseLogger(const std::string& name) override;
+
     [[nodiscard]]
     std::string_view GetName() const override;
 
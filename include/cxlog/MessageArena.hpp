@@ -0,0 +1,55 @@
+#pragma once
+#include "cxlog/defs.hpp"
+
+#include <memory_resource>
+
+CXLOG_NAMESPACE_BEGIN
+
+namespace details
+{
+    /**
+     * @brief Per-thread monotonic arena used while building and dispatching a message
+     *
+     * @details Memory handed out by the arena is released all at once, when the outermost ArenaScope on the
+     * thread ends. Allocations within the arena are a pointer bump; it only falls back to the heap once its
+     * initial block is exhausted.
+     *
+     * @return Memory resource of the calling thread
+     */
+    CXLOG_API std::pmr::memory_resource* MessageArena() noexcept;
+
+    /**
+     * @brief Marks the duration of building and dispatching a message on the calling thread
+     *
+     * @details Scopes nest; the arena is reset when the outermost scope ends, so a message built by a provider
+     * while it is handling another one does not invalidate the outer message.
+     *
+     * When the library is built with ENABLE_ALLOCATION_GUARD, any global heap allocation inside a scope on
+     * a thread which already completed one dispatch (i.e. once thread local buffers are warmed up) is reported
+     * and aborts the process.
+     */
+    class CXLOG_API ArenaScope
+    {
+    public:
+        ArenaScope() noexcept;
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator=(const ArenaScope&) = delete;
+    };
+
+    /**
+     * @brief Exempts cold paths, such as file rotation or sinks storing messages, from the allocation guard
+     */
+    class CXLOG_API AllowAllocations
+    {
+    public:
+        AllowAllocations() noexcept;
+        ~AllowAllocations();
+
+        AllowAllocations(const AllowAllocations&) = delete;
+        AllowAllocations& operator=(const AllowAllocations&) = delete;
+    };
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,95 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/MessageArena.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+CXLOG_NAMESPACE_BEGIN
+
+namespace details
+{
+    /**
+     * @brief Character buffer used to build a message at the call site
+     *
+     * @details Content is kept in inline storage, so messages up to InlineSize bytes are built without touching
+     * the heap. Longer messages spill over into a string allocated from the thread's MessageArena, so the buffer
+     * must not outlive the ArenaScope it was created in.
+     */
+    class MessageBuffer
+    {
+    public:
+        static constexpr std::size_t InlineSize = 512;
+
+        MessageBuffer() = default;
+        MessageBuffer(const MessageBuffer&) = delete;
+        MessageBuffer& operator=(const MessageBuffer&) = delete;
+
+        void append(const char* data, std::size_t size)
+        {
+            if (_spilled)
+            {
+                _spilled->append(data, size);
+            }
+            else if (_size + size <= InlineSize)
+            {
+                std::memcpy(_inline + _size, data, size);
+                _size += size;
+            }
+            else
+            {
+                _spilled.emplace(MessageArena());
+                _spilled->reserve(2 * (_size + size));
+                _spilled->assign(_inline, _size);
+                _spilled->append(data, size);
+            }
+        }
+
+        void append(std::string_view text) { append(text.data(), text.size()); }
+
+        void push_back(char c) { append(&c, 1); }
+
+        [[nodiscard]]
+        std::string_view view() const noexcept
+        {
+            return _spilled ? std::string_view(*_spilled) : std::string_view(_inline, _size);
+        }
+
+    private:
+        char _inline[InlineSize];
+        std::size_t _size {0};
+        std::optional<std::pmr::string> _spilled;
+    };
+
+    /**
+     * @brief Stream buffer appending everything written to it into a MessageBuffer
+     */
+    class MessageStreamBuf : public std::streambuf
+    {
+    public:
+        explicit MessageStreamBuf(MessageBuffer& buffer) : _buffer(buffer) {}
+
+    protected:
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+                _buffer.push_back(traits_type::to_char_type(ch));
+            return traits_type::not_eof(ch);
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            _buffer.append(s, static_cast<std::size_t>(n));
+            return n;
+        }
+
+    private:
+        MessageBuffer& _buffer;
+    };
+}
+
+CXLOG_NAMESPACE_END
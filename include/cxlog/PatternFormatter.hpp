@@ -0,0 +1,107 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/LogRecord.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Compiled log line layout
+ *
+ * @details The pattern is parsed once into a list of formatting operations. Constant pieces, including the category
+ * name of the logger owning the formatter, are merged into literal runs, so rendering a line is a sequence of
+ * appends into a reusable buffer without any intermediate allocations. Time fields and the thread id are taken from
+ * the record being formatted.
+ *
+ * Supported fields:
+ *  - %Y, %m, %d      year, month and day of month (local time)
+ *  - %H, %M, %S      hours, minutes and seconds (local time)
+ *  - %F, %T          shorthands for %Y-%m-%d and %H:%M:%S
+ *  - %e, %f          milliseconds and microseconds part of the timestamp
+ *  - %l              level name (see @ref to_string)
+ *  - %c              category name
+ *  - %t              thread id
+ *  - %P              process id
+ *  - %v              message
+ *  - %J              message escaped for the inside of a JSON string (see AppendEscaped())
+ *  - %V              message with control characters escaped, so that it always stays on a single line
+ *  - %D              duration of a span, e.g. "250us", empty for plain messages (see Span)
+ *  - %X              diagnostic context as "key=value" pairs separated by spaces (see ScopedContext)
+ *  - %X{key}         value of a single context field, empty if not set
+ *  - %s, %#, %!      source file name, line and function of the statement, empty if unknown (see CallSite)
+ *  - %n              new line
+ *  - %%              percent sign
+ *
+ * Message is %v rather than %m, as %m keeps its strftime meaning of month. Unknown fields are copied verbatim.
+ */
+class CXLOG_API PatternFormatter
+{
+public:
+    /** Layout used by providers unless configured otherwise, e.g. "[Info] main: Hello\n" */
+    static constexpr const char* DefaultPattern = "[%l] %c: %v%n";
+
+    /**
+     * @brief Compiles the pattern
+     * @param pattern Line layout
+     * @param category Category name substituted for %c
+     */
+    explicit PatternFormatter(std::string_view pattern = DefaultPattern, std::string_view category = {});
+
+    /**
+     * @brief Appends formatted line to the output buffer
+     * @param out Buffer to append to. Its capacity is reused by subsequent calls when cleared by the caller.
+     * @param record Record to format
+     */
+    void Format(std::string& out, const LogRecord& record) const;
+
+    /**
+     * @brief Appends formatted line for a message logged now from the calling thread
+     */
+    void Format(std::string& out, LogLevel level, std::string_view message) const;
+
+    /**
+     * @return Source pattern this formatter was compiled from
+     */
+    [[nodiscard]]
+    std::string_view Pattern() const noexcept { return *_pattern; }
+
+    /**
+     * @return Identity of the layout; formatters compiled from equal patterns return the same value
+     */
+    [[nodiscard]]
+    const void* Layout() const noexcept { return _pattern; }
+
+    /**
+     * @return Bytes allocated by the compiled layout, excluding the formatter itself and the shared source pattern
+     */
+    [[nodiscard]]
+    std::size_t MemoryUsage() const noexcept { return _literals.capacity() + _ops.capacity() * sizeof(Op); }
+
+private:
+    enum class OpKind : std::uint8_t
+    {
+        Literal, Level, Message, JsonMessage, TextMessage, ThreadId, ProcessId, Context, ContextField, Duration, SourceFile, SourceLine, Function,
+        Year, Month, Day, Hour, Minute, Second, Millis, Micros,
+    };
+
+    struct Op
+    {
+        OpKind kind;
+        std::uint32_t offset;   /**< Offset into _literals, for OpKind::Literal and the key of OpKind::ContextField */
+        std::uint32_t length;   /**< Length of the literal or key */
+    };
+
+    void AddLiteral(std::string_view text);
+    void AddField(OpKind kind);
+
+    const std::string* _pattern;    /**< Interned source pattern */
+    std::string _literals;
+    std::vector<Op> _ops;
+    bool _needsTime {false};
+};
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,136 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/ILoggerProvider.hpp"
+#include "cxlog/PatternFormatter.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * Shared memory provider options.
+ */
+struct SharedMemoryProviderOptions
+{
+    LogLevel minLevel = LogLevel::Trace;            /**< Minimum level of messages to be accepted by this provider */
+    std::uint32_t slotCount {4096};                 /**< Number of records the ring holds, must be a power of two */
+    std::uint32_t slotSize {512};                   /**< Bytes per record including a 32 byte header, multiple of 64.
+                                                         Longer lines are truncated. */
+    std::string pattern {PatternFormatter::DefaultPattern}; /**< Line layout (see @ref PatternFormatter) */
+    bool unlink {true};                             /**< Remove the shared memory object when the provider is destroyed */
+};
+
+/**
+ * Shared memory provider.
+ *
+ * @brief Publishes rendered lines into a POSIX shared memory ring, to be consumed live by another process
+ * (see @ref SharedMemoryReader and the cxlog-shmtail tool).
+ *
+ * @details The ring is a fixed array of slots. Writers claim a sequence number with a single atomic increment and
+ * publish the slot with a per-slot sequence word (odd while being written), so logging never blocks and never
+ * waits for readers: once the ring is full, the oldest records are overwritten. Readers detect records they lost
+ * this way from the sequence numbers.
+ */
+class CXLOG_API SharedMemoryProvider : public ILoggerProvider
+{
+public:
+    /**
+     * @param name Name of the shared memory object, e.g. "/myapp-log"
+     * @param opt Provider options
+     * @throws std::invalid_argument on invalid options
+     * @throws std::system_error if the shared memory object can't be created
+     */
+    explicit SharedMemoryProvider(const std::string& name, SharedMemoryProviderOptions opt = {});
+    ~SharedMemoryProvider() override;
+
+    /**
+     * Creates logger with given category name.
+     *
+     * @note Multiple calls with same category name returns the same instance.
+     */
+    std::shared_ptr<ILogger> GetLogger(const std::string& name) override;
+
+    /**
+     * Drops the logger of given category name; it keeps working for whoever still holds it.
+     */
+    void ReleaseLogger(const std::string& name) override;
+
+    /**
+     * @return Provider name
+     */
+    [[nodiscard]]
+    std::string_view GetName() const override;
+
+private:
+    struct SharedData;
+    friend class SharedMemoryLogger;
+
+    std::map<std::string, std::shared_ptr<ILogger>> _loggers;
+    std::shared_ptr<SharedData> _providerData;  /**< Shared data for all loggers created by this provider */
+};
+
+/**
+ * @brief Consumer side of a SharedMemoryProvider ring
+ *
+ * @details Records are read in place: the returned line points straight into the shared memory. As the producer
+ * may overwrite a slot at any time, the line must be checked with Valid() after it has been consumed (e.g. copied
+ * into an output buffer), and discarded if it was overwritten meanwhile.
+ */
+class CXLOG_API SharedMemoryReader
+{
+public:
+    enum class Status
+    {
+        Ok,         /**< Record has been read */
+        Empty,      /**< No new record has been published yet */
+        Lapped,     /**< Reader fell behind and records were overwritten; see Lost() */
+    };
+
+    struct Record
+    {
+        std::uint64_t Sequence {0};     /**< Sequence number of the record */
+        LogLevel Level {LogLevel::Trace};
+        std::int64_t Timestamp {0};     /**< Microseconds since epoch */
+        std::string_view Line;          /**< Rendered line, points into shared memory */
+    };
+
+    /**
+     * @param name Name of the shared memory object
+     * @param fromOldest Start with the oldest record still in the ring, rather than with the next one published
+     * @throws std::system_error if the object can't be opened
+     * @throws std::runtime_error if it is not a ring created by SharedMemoryProvider
+     */
+    explicit SharedMemoryReader(const std::string& name, bool fromOldest = true);
+    ~SharedMemoryReader();
+
+    SharedMemoryReader(const SharedMemoryReader&) = delete;
+    SharedMemoryReader& operator=(const SharedMemoryReader&) = delete;
+
+    /**
+     * @brief Reads the next record
+     * @param record Receives the record on Status::Ok
+     */
+    Status Read(Record& record) noexcept;
+
+    /**
+     * @return true if the record has not been overwritten since it was read
+     */
+    [[nodiscard]]
+    bool Valid(const Record& record) const noexcept;
+
+    /**
+     * @return Number of records lost due to the reader being lapped
+     */
+    [[nodiscard]]
+    std::uint64_t Lost() const noexcept { return _lost; }
+
+private:
+    const std::byte* _memory {nullptr};
+    std::size_t _size {0};
+    std::uint64_t _next {0};
+    std::uint64_t _lost {0};
+};
+
+CXLOG_NAMESPACE_END
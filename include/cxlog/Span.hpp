@@ -0,0 +1,71 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/ILogger.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string_view>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Scoped timer, logging a record with its duration when it goes out of scope
+ *
+ * @details Start and end are taken from the monotonic clock. The emitted record carries the span name as its message
+ * along with SpanStart and SpanDuration (see @ref LogRecord), so text providers can print the duration through the
+ * %D pattern field and TraceEventProvider turns it into a complete event on the timeline.
+ *
+ * Whether the level is enabled is checked once, when the span starts; a disabled span costs one branch in its
+ * destructor.
+ *
+ * @code
+ * {
+ *     cxlog::Span span(logger, "db.query");
+ *     RunQuery();
+ * }
+ * @endcode
+ */
+class CXLOG_API Span
+{
+public:
+    /**
+     * @param logger Logger to emit the span through, must outlive the span
+     * @param name Span name, must outlive the span (typically a string literal)
+     * @param level Severity of the emitted record
+     */
+    Span(ILogger& logger, std::string_view name, LogLevel level = LogLevel::Debug) noexcept
+        : _logger(logger.IsEnabled(level) ? &logger : nullptr)
+        , _name(name)
+        , _level(level)
+    {
+        if (_logger)
+            _start = std::chrono::steady_clock::now();
+    }
+
+    Span(const std::shared_ptr<ILogger>& logger, std::string_view name, LogLevel level = LogLevel::Debug) noexcept
+        : Span(*logger, name, level)
+    {
+    }
+
+    ~Span()
+    {
+        if (_logger)
+            End();
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    /**
+     * @brief Ends the span before it goes out of scope. Has no effect if already ended or disabled.
+     */
+    void End() noexcept;
+
+private:
+    ILogger* _logger;
+    std::string_view _name;
+    LogLevel _level;
+    std::chrono::steady_clock::time_point _start;
+};
+
+CXLOG_NAMESPACE_END
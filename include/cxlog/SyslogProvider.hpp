@@ -22,6 +22,11 @@ public:
      */
     std::shared_ptr<ILogger> GetLogger(const std::string& name) override;
 
+    /**
+     * Drops the logger of given category name; it keeps working for whoever still holds it.
+     */
+    void ReleaseLogger(const std::string& name) override;
+
     /**
      * Returns the name of the provider
      *
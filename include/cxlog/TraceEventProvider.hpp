@@ -0,0 +1,71 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/ILoggerProvider.hpp"
+
+#include <filesystem>
+#include <map>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * Trace event provider options.
+ */
+struct TraceEventProviderOptions
+{
+    LogLevel minLevel = LogLevel::Trace;    /**< Minimum level of records to be accepted by this provider */
+    bool spansOnly {false};                 /**< Ignore plain messages, only record spans (see @ref Span) */
+    std::size_t bufferSize {16 * 1024};     /**< Per-thread buffer size, events are written out once it fills up */
+};
+
+/**
+ * Trace event provider.
+ *
+ * @brief Writes spans as complete events and plain messages as instant events into a Chrome trace-event JSON file,
+ * which can be opened in chrome://tracing or Perfetto.
+ *
+ * @details Events are serialized into a buffer owned by the logging thread and appended to the file in chunks, so
+ * threads only contend for the file when their buffer fills up or on Flush(). Event timestamps are microseconds on
+ * the monotonic clock. The JSON array is terminated on Shutdown() or when the provider and all its loggers are gone.
+ */
+class CXLOG_API TraceEventProvider : public ILoggerProvider
+{
+public:
+    explicit TraceEventProvider(const std::filesystem::path& file, TraceEventProviderOptions opt = {});
+
+    /**
+     * Creates logger with given category name, used as the event category.
+     *
+     * @note Multiple calls with same category name returns the same instance.
+     */
+    std::shared_ptr<ILogger> GetLogger(const std::string& name) override;
+
+    /**
+     * Drops the logger of given category name; it keeps working for whoever still holds it.
+     */
+    void ReleaseLogger(const std::string& name) override;
+
+    /**
+     * @return Provider name
+     */
+    [[nodiscard]]
+    std::string_view GetName() const override;
+
+    /**
+     * Writes buffered events of all threads into the file
+     */
+    std::future<void> Flush() override;
+
+    /**
+     * Writes buffered events and closes the JSON array. Events logged afterwards are discarded.
+     */
+    std::future<void> Shutdown(std::chrono::steady_clock::time_point deadline) override;
+
+private:
+    struct SharedData;
+    friend class TraceEventLogger;
+
+    std::map<std::string, std::shared_ptr<ILogger>> _loggers;
+    std::shared_ptr<SharedData> _providerData;  /**< Shared data for all loggers created by this provider */
+};
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,344 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/LoggerFactory.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Queue handing records over to a consumer thread (see AsyncQueue and ShardedQueue)
+ */
+template<typename T>
+class IAsyncQueue
+{
+public:
+    virtual ~IAsyncQueue() = default;
+
+    /**
+     * @brief Enqueue an item according to the configured overflow policy
+     * @param level Severity of the item, used for lane selection and DropBelowLevel policy
+     * @param item Item to enqueue
+     * @return true if the item was queued, false if it was dropped
+     */
+    virtual bool Push(LogLevel level, T&& item) = 0;
+
+    /**
+     * @brief Runs an action on the worker thread once all items queued so far have been handled
+     * @param action Action to run, may be empty
+     * @return Future which becomes ready after the action has run
+     */
+    virtual std::future<void> AddBarrier(std::function<void()> action = {}) = 0;
+
+    /**
+     * @brief Discards items still queued when the consumer gets to them after the deadline
+     */
+    virtual void DiscardAfter(std::chrono::steady_clock::time_point deadline) = 0;
+
+    /**
+     * @brief Stops accepting new items, drains the queue and joins the worker thread
+     */
+    virtual void Stop() = 0;
+
+    [[nodiscard]]
+    virtual AsyncStats Stats() const noexcept = 0;
+};
+
+/**
+ * @brief Bounded two-lane queue with a single consumer thread
+ *
+ * @details Records at or above AsyncOptions::PriorityLevel are pushed into a separate priority lane, which the
+ * consumer always drains first. The normal lane applies AsyncOptions::Policy when it runs full. Items are handed
+ * over to the consumer callback on the worker thread, one at a time and outside of the queue lock.
+ *
+ * Barriers let the owner run an action on the worker thread once everything queued before it has been handled,
+ * which is how providers are flushed without racing the consumer.
+ *
+ * @tparam T Queued item; must be default constructible and move assignable.
+ */
+template<typename T>
+class AsyncQueue : public IAsyncQueue<T>
+{
+    /* Fixed size ring buffer, guarded by the queue mutex */
+    struct Lane
+    {
+        std::vector<T> items;
+        std::size_t head {0};
+        std::size_t count {0};
+        std::uint64_t pushed {0};   /**< Number of items ever pushed */
+        std::uint64_t done {0};     /**< Number of items handled by the consumer or evicted */
+
+        explicit Lane(std::size_t capacity) : items(capacity > 0 ? capacity : 1) {}
+
+        [[nodiscard]] bool full() const noexcept { return count == items.size(); }
+        [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+        void push(T&& item)
+        {
+            items[(head + count) % items.size()] = std::move(item);
+            ++count;
+            ++pushed;
+        }
+
+        T pop()
+        {
+            T item = std::move(items[head]);
+            items[head] = T{};
+            head = (head + 1) % items.size();
+            --count;
+            return item;
+        }
+    };
+
+    struct Barrier
+    {
+        std::uint64_t normal;       /**< Normal lane items which must be done first */
+        std::uint64_t priority;     /**< Priority lane items which must be done first */
+        std::function<void()> action;
+        std::promise<void> promise;
+    };
+
+public:
+    using Consumer = std::function<void(T&)>;
+
+    AsyncQueue(const AsyncOptions& options, Consumer consumer)
+        : _options(options)
+        , _consumer(std::move(consumer))
+        , _normal(options.Capacity)
+        , _priority(options.PriorityCapacity)
+    {
+        _worker = std::thread([this]{ Run(); });
+    }
+
+    ~AsyncQueue() override
+    {
+        Stop();
+    }
+
+    AsyncQueue(const AsyncQueue&) = delete;
+    AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+    bool Push(LogLevel level, T&& item) override
+    {
+        const bool priority = level >= _options.PriorityLevel;
+
+        std::unique_lock lock(_mutex);
+        if (_stopped)
+            return false;
+
+        Lane& lane = priority ? _priority : _normal;
+        if (lane.full())
+        {
+            auto policy = priority ? OverflowPolicy::Block : _options.Policy;
+            if (policy == OverflowPolicy::DropBelowLevel)
+            {
+                if (level < _options.DropLevel)
+                {
+                    _droppedBelowLevel.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                policy = OverflowPolicy::Block;
+            }
+
+            switch (policy)
+            {
+                case OverflowPolicy::DropNewest:
+                    _droppedNewest.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+
+                case OverflowPolicy::DropOldest:
+                    lane.pop();
+                    ++lane.done;
+                    _droppedOldest.fetch_add(1, std::memory_order_relaxed);
+                    break;
+
+                default:
+                    if (!_notFull.wait_for(lock, _options.BlockTimeout, [&]{ return _stopped || !lane.full(); }) || _stopped)
+                    {
+                        _droppedTimeout.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    break;
+            }
+        }
+
+        lane.push(std::move(item));
+        _enqueued.fetch_add(1, std::memory_order_relaxed);
+        lock.unlock();
+
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    std::future<void> AddBarrier(std::function<void()> action = {}) override
+    {
+        std::unique_lock lock(_mutex);
+
+        auto& barrier = _barriers.emplace_back();
+        barrier.normal = _normal.pushed;
+        barrier.priority = _priority.pushed;
+        barrier.action = std::move(action);
+        auto future = barrier.promise.get_future();
+
+        /* Worker is gone, run the barrier right away */
+        if (_finished)
+        {
+            RunBarriers(lock, true);
+            return future;
+        }
+
+        lock.unlock();
+        _notEmpty.notify_one();
+        return future;
+    }
+
+    void DiscardAfter(std::chrono::steady_clock::time_point deadline) override
+    {
+        std::lock_guard lock(_mutex);
+        _discardAfter = deadline;
+    }
+
+    void Stop() override
+    {
+        {
+            std::lock_guard lock(_mutex);
+            if (_stopped)
+                return;
+            _stopped = true;
+        }
+
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+
+        if (_worker.joinable())
+            _worker.join();
+    }
+
+    [[nodiscard]]
+    AsyncStats Stats() const noexcept override
+    {
+        AsyncStats stats;
+        stats.Enqueued = _enqueued.load(std::memory_order_relaxed);
+        stats.Dispatched = _dispatched.load(std::memory_order_relaxed);
+        stats.DroppedNewest = _droppedNewest.load(std::memory_order_relaxed);
+        stats.DroppedOldest = _droppedOldest.load(std::memory_order_relaxed);
+        stats.DroppedBelowLevel = _droppedBelowLevel.load(std::memory_order_relaxed);
+        stats.DroppedTimeout = _droppedTimeout.load(std::memory_order_relaxed);
+        stats.Discarded = _discarded.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    [[nodiscard]]
+    bool BarrierReady() const noexcept
+    {
+        return !_barriers.empty()
+            && _barriers.front().normal <= _normal.done
+            && _barriers.front().priority <= _priority.done;
+    }
+
+    /* Runs barriers whose items are done, or all of them if forced. Called with the lock held. */
+    void RunBarriers(std::unique_lock<std::mutex>& lock, bool force)
+    {
+        while (force ? !_barriers.empty() : BarrierReady())
+        {
+            Barrier barrier = std::move(_barriers.front());
+            _barriers.pop_front();
+            lock.unlock();
+
+            try
+            {
+                if (barrier.action)
+                    barrier.action();
+                barrier.promise.set_value();
+            }
+            catch (...)
+            {
+                barrier.promise.set_exception(std::current_exception());
+            }
+
+            lock.lock();
+        }
+    }
+
+    void Run()
+    {
+        std::unique_lock lock(_mutex);
+        for (;;)
+        {
+            _notEmpty.wait(lock, [this]{ return _stopped || !_priority.empty() || !_normal.empty() || BarrierReady(); });
+
+            RunBarriers(lock, false);
+
+            if (_priority.empty() && _normal.empty())
+            {
+                if (!_stopped)
+                    continue;
+
+                /* Stopped and drained */
+                RunBarriers(lock, true);
+                _finished = true;
+                return;
+            }
+
+            const bool priority = !_priority.empty();
+            T item = priority ? _priority.pop() : _normal.pop();
+            const bool discard = std::chrono::steady_clock::now() > _discardAfter;
+            lock.unlock();
+            _notFull.notify_all();
+
+            if (discard)
+            {
+                _discarded.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                try
+                {
+                    _consumer(item);
+                }
+                catch (...)
+                {
+                }
+                _dispatched.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            item = T{};
+            lock.lock();
+            ++(priority ? _priority : _normal).done;
+        }
+    }
+
+    const AsyncOptions _options;
+    const Consumer _consumer;
+
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    Lane _normal;
+    Lane _priority;
+    std::deque<Barrier> _barriers;
+    std::chrono::steady_clock::time_point _discardAfter {std::chrono::steady_clock::time_point::max()};
+    bool _stopped {false};
+    bool _finished {false};
+
+    std::atomic<std::uint64_t> _enqueued {0};
+    std::atomic<std::uint64_t> _dispatched {0};
+    std::atomic<std::uint64_t> _droppedNewest {0};
+    std::atomic<std::uint64_t> _droppedOldest {0};
+    std::atomic<std::uint64_t> _droppedBelowLevel {0};
+    std::atomic<std::uint64_t> _droppedTimeout {0};
+    std::atomic<std::uint64_t> _discarded {0};
+
+    std::thread _worker;
+};
+
+CXLOG_NAMESPACE_END
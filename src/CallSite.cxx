@@ -0,0 +1,218 @@
+#include "cxlog/CallSite.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+/* Parsed selector of SetCallSiteMode() together with the mode it sets */
+struct SiteRule
+{
+    enum class Kind { File, Function, Format } kind;
+    std::string text;
+    std::uint32_t line {0};     /**< 0 for all lines of the file */
+    SiteMode mode;
+
+    static SiteRule Parse(std::string_view selector, SiteMode mode)
+    {
+        auto trimmed = selector;
+        while (!trimmed.empty() && (trimmed.front() == ' ' || trimmed.front() == '\t'))
+            trimmed.remove_prefix(1);
+        while (!trimmed.empty() && (trimmed.back() == ' ' || trimmed.back() == '\t' || trimmed.back() == '\r'))
+            trimmed.remove_suffix(1);
+
+        if (trimmed.size() >= 2 && trimmed.front() == '"' && trimmed.back() == '"')
+            return {Kind::Format, std::string(trimmed.substr(1, trimmed.size() - 2)), 0, mode};
+
+        if (trimmed.size() > 2 && trimmed.substr(trimmed.size() - 2) == "()")
+            return {Kind::Function, std::string(trimmed.substr(0, trimmed.size() - 2)), 0, mode};
+
+        /* A trailing ":digits" is the line; any other colon belongs to the path */
+        std::uint32_t line = 0;
+        auto colon = trimmed.rfind(':');
+        auto digits = colon == std::string_view::npos ? std::string_view() : trimmed.substr(colon + 1);
+        if (!digits.empty() && digits.find_first_not_of("0123456789") == std::string_view::npos)
+        {
+            auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), line);
+            if (ec != std::errc() || line == 0)
+                throw std::invalid_argument("CallSite: invalid line in selector '" + std::string(selector) + "'");
+            trimmed = trimmed.substr(0, colon);
+        }
+
+        if (trimmed.empty())
+            throw std::invalid_argument("CallSite: empty selector");
+
+        return {Kind::File, std::string(trimmed), line, mode};
+    }
+
+    [[nodiscard]]
+    bool SameSelector(const SiteRule& other) const noexcept
+    {
+        return kind == other.kind && text == other.text && line == other.line;
+    }
+
+    [[nodiscard]]
+    bool Matches(const CallSite& site) const noexcept
+    {
+        switch (kind)
+        {
+            case Kind::Format:
+                return site.Format.find(text) != std::string_view::npos;
+
+            case Kind::Function:
+                return text == site.Function;
+
+            case Kind::File:
+            {
+                if (line != 0 && line != site.Line)
+                    return false;
+
+                /* Whole trailing path components only, so that "Server.cxx" doesn't match "MyServer.cxx" */
+                std::string_view file = site.File;
+                if (file.size() < text.size() || file.substr(file.size() - text.size()) != text)
+                    return false;
+
+                auto before = file.size() - text.size();
+                return before == 0 || file[before - 1] == '/' || file[before - 1] == '\\';
+            }
+        }
+        return false;
+    }
+};
+
+/* Sites register from static initializers of any module, so the registry is created on first use */
+struct SiteRegistry
+{
+    std::mutex mutex;
+    std::vector<const CallSite*> sites;
+    std::vector<SiteRule> rules;        /**< Applied in order to sites registered later */
+
+    static SiteRegistry& Get()
+    {
+        static SiteRegistry registry;
+        return registry;
+    }
+
+    /* Called with mutex held */
+    std::size_t Apply(const SiteRule& rule)
+    {
+        std::size_t matched = 0;
+        for (auto site : sites)
+        {
+            if (site->Mode && rule.Matches(*site))
+            {
+                site->Mode->store(rule.mode, std::memory_order_relaxed);
+                ++matched;
+            }
+        }
+        return matched;
+    }
+};
+
+std::vector<const CallSite*> RegisteredCallSites()
+{
+    auto& registry = SiteRegistry::Get();
+    std::vector<const CallSite*> sites;
+    {
+        std::lock_guard lock(registry.mutex);
+        sites = registry.sites;
+    }
+
+    std::sort(sites.begin(), sites.end(), [](const CallSite* a, const CallSite* b) {
+        auto cmp = std::strcmp(a->File, b->File);
+        return cmp != 0 ? cmp < 0 : a->Line < b->Line;
+    });
+    return sites;
+}
+
+std::size_t SetCallSiteMode(std::string_view selector, SiteMode mode)
+{
+    auto rule = SiteRule::Parse(selector, mode);
+
+    auto& registry = SiteRegistry::Get();
+    std::lock_guard lock(registry.mutex);
+
+    /* Only the latest mode of a selector matters for sites registered later */
+    auto& rules = registry.rules;
+    rules.erase(std::remove_if(rules.begin(), rules.end(), [&](const SiteRule& r) { return r.SameSelector(rule); }),
+                rules.end());
+    rules.push_back(rule);
+    return registry.Apply(rule);
+}
+
+std::size_t ApplyCallSiteControl(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("CallSite: can't read control file " + path);
+
+    std::vector<SiteRule> rules;
+    std::string line;
+    for (std::size_t number = 1; std::getline(file, line); ++number)
+    {
+        std::string_view text = line;
+        auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos || text[first] == '#')
+            continue;
+
+        text.remove_prefix(first);
+        auto op = text.front();
+        auto mode = op == '+' ? SiteMode::Enabled : op == '-' ? SiteMode::Disabled : SiteMode::Default;
+        if (op != '+' && op != '-' && op != '=')
+            throw std::invalid_argument(path + ":" + std::to_string(number) + ": expected +, - or = before the selector");
+
+        try
+        {
+            rules.push_back(SiteRule::Parse(text.substr(1), mode));
+        }
+        catch (const std::invalid_argument& e)
+        {
+            throw std::invalid_argument(path + ":" + std::to_string(number) + ": " + e.what());
+        }
+    }
+
+    auto& registry = SiteRegistry::Get();
+    std::lock_guard lock(registry.mutex);
+
+    for (auto site : registry.sites)
+    {
+        if (site->Mode)
+            site->Mode->store(SiteMode::Default, std::memory_order_relaxed);
+    }
+
+    registry.rules = std::move(rules);
+    for (const auto& rule : registry.rules)
+        registry.Apply(rule);
+
+    return std::count_if(registry.sites.begin(), registry.sites.end(), [](const CallSite* site) {
+        return site->Mode && site->Mode->load(std::memory_order_relaxed) != SiteMode::Default;
+    });
+}
+
+bool details::RegisterCallSite(const CallSite* site) noexcept
+{
+    auto& registry = SiteRegistry::Get();
+    try
+    {
+        std::lock_guard lock(registry.mutex);
+        registry.sites.push_back(site);
+
+        for (const auto& rule : registry.rules)
+        {
+            if (site->Mode && rule.Matches(*site))
+                site->Mode->store(rule.mode, std::memory_order_relaxed);
+        }
+    }
+    catch (...)
+    {
+    }
+    return true;
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,201 @@
+#include "CompressedFile.hpp"
+#include "Compression.hpp"
+
+#include "cxlog/MessageArena.hpp"
+
+#include <cstring>
+#include <utility>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+/* Frames queued ahead of the writer before the caller waits */
+static constexpr std::size_t MaxPendingFrames = 4;
+
+
+CompressedFile::CompressedFile(FileCompression codec, int level, std::size_t frameSize)
+    : _codec(codec), _level(level), _frameSize(frameSize), _thread([this] { Run(); })
+{
+    _frame.reserve(_frameSize);
+}
+
+CompressedFile::~CompressedFile()
+{
+    Close();
+    {
+        std::lock_guard lock(_mutex);
+        _stopped = true;
+    }
+    _wakeup.notify_all();
+    _thread.join();
+}
+
+void CompressedFile::Open(const std::filesystem::path& name)
+{
+    QueueFrame();
+    Wait(Enqueue(JobKind::Open, name.string()));
+}
+
+void CompressedFile::Write(std::string_view line)
+{
+    _frame.append(line);
+    if (_frame.size() >= _frameSize)
+        QueueFrame();
+}
+
+void CompressedFile::Flush()
+{
+    QueueFrame();
+    Wait(Enqueue(JobKind::Flush, {}));
+}
+
+void CompressedFile::Close()
+{
+    QueueFrame();
+    Wait(Enqueue(JobKind::Close, {}));
+}
+
+std::uint64_t CompressedFile::Enqueue(JobKind kind, std::string data)
+{
+    /* Queue nodes are allocated per frame or flush, not per record */
+    details::AllowAllocations allow;
+    std::unique_lock lock(_mutex);
+    if (kind == JobKind::Frame)
+        _done.wait(lock, [&] { return _queue.size() < MaxPendingFrames; });
+
+    _queue.push_back(Job{kind, std::move(data)});
+    auto sequence = ++_queued;
+    lock.unlock();
+
+    _wakeup.notify_one();
+    return sequence;
+}
+
+void CompressedFile::Wait(std::uint64_t sequence)
+{
+    std::unique_lock lock(_mutex);
+    _done.wait(lock, [&] { return _completed >= sequence; });
+}
+
+/* Hands the current frame over to the writer and continues in a recycled buffer */
+void CompressedFile::QueueFrame()
+{
+    if (_frame.empty())
+        return;
+
+    std::string next;
+    {
+        std::lock_guard lock(_mutex);
+        if (!_free.empty())
+        {
+            next = std::move(_free.back());
+            _free.pop_back();
+        }
+    }
+    if (next.capacity() < _frameSize)
+        next.reserve(_frameSize);
+
+    std::swap(next, _frame);
+    Enqueue(JobKind::Frame, std::move(next));
+}
+
+void CompressedFile::Run()
+{
+    std::unique_lock lock(_mutex);
+    while (true)
+    {
+        _wakeup.wait(lock, [&] { return _stopped || !_queue.empty(); });
+        if (_queue.empty())
+            break;
+
+        auto job = std::move(_queue.front());
+        _queue.pop_front();
+        lock.unlock();
+
+        switch (job.kind)
+        {
+            case JobKind::Frame:
+                WriteFrame(job.data);
+                break;
+            case JobKind::Open:
+                Finish();
+                _file = std::ofstream(job.data, std::ios::binary | std::ios::trunc);
+                {
+                    compressed_log::FileHeader header {};
+                    std::memcpy(header.magic, compressed_log::FileMagic, sizeof(header.magic));
+                    header.codec = static_cast<std::uint8_t>(_codec);
+                    header.frameSize = static_cast<std::uint32_t>(_frameSize);
+                    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    _offset = sizeof(header);
+                }
+                break;
+            case JobKind::Flush:
+                _file.flush();
+                break;
+            case JobKind::Close:
+                Finish();
+                break;
+        }
+
+        lock.lock();
+        if (job.kind == JobKind::Frame)
+        {
+            job.data.clear();
+            _free.push_back(std::move(job.data));
+        }
+        ++_completed;
+        _done.notify_all();
+    }
+}
+
+void CompressedFile::WriteFrame(const std::string& lines)
+{
+    if (!_file.is_open())
+        return;
+
+    _compressed.resize(details::CompressBound(_codec, lines.size()));
+    auto size = details::Compress(_codec, _level, lines, _compressed.data());
+
+    compressed_log::FrameHeader header {};
+    header.magic = compressed_log::FrameMagic;
+    header.rawSize = static_cast<std::uint32_t>(lines.size());
+
+    const char* payload = _compressed.data();
+    if (size == 0 || size >= lines.size())
+    {
+        header.flags = compressed_log::FrameStored;
+        payload = lines.data();
+        size = lines.size();
+    }
+    header.size = static_cast<std::uint32_t>(size);
+
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _file.write(payload, static_cast<std::streamsize>(size));
+
+    _index.push_back({_offset, _rawOffset, header.size, header.rawSize});
+    _offset += sizeof(header) + size;
+    _rawOffset += lines.size();
+}
+
+/* Appends the frame index and closes the current file */
+void CompressedFile::Finish()
+{
+    if (!_file.is_open())
+        return;
+
+    compressed_log::IndexFooter footer {};
+    footer.indexOffset = _offset;
+    footer.count = _index.size();
+    std::memcpy(footer.magic, compressed_log::IndexMagic, sizeof(footer.magic));
+
+    _file.write(reinterpret_cast<const char*>(_index.data()),
+                static_cast<std::streamsize>(_index.size() * sizeof(compressed_log::FrameEntry)));
+    _file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    _file.close();
+
+    _index.clear();
+    _offset = 0;
+    _rawOffset = 0;
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,91 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/CompressedLog.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Writes a block compressed log file (see compressed_log) on a thread of its own
+ *
+ * @details Lines are collected into a frame buffer by the caller; once it holds frameSize bytes, it is queued to the
+ * writer thread, which compresses and writes it while the caller moves on to a fresh buffer. Buffers are recycled,
+ * and the caller only waits when the writer falls behind by more than a few frames. Frames always end with a whole
+ * line, so each of them decompresses into whole lines. The frame index is written when the file is finished, on
+ * Open() of the next one, Close() or destruction.
+ */
+class CompressedFile
+{
+public:
+    CompressedFile(FileCompression codec, int level, std::size_t frameSize);
+    ~CompressedFile();
+
+    CompressedFile(const CompressedFile&) = delete;
+    CompressedFile& operator=(const CompressedFile&) = delete;
+
+    /** @brief Finishes the current file and starts writing name; returns once name has been created */
+    void Open(const std::filesystem::path& name);
+
+    /** @brief Appends a whole line to the current frame, queueing the frame once it is full */
+    void Write(std::string_view line);
+
+    /** @brief Writes the partially filled frame and waits until it has been handed to the kernel */
+    void Flush();
+
+    /** @brief Finishes the current file and waits until it has been closed */
+    void Close();
+
+private:
+    enum class JobKind { Frame, Open, Flush, Close };
+
+    struct Job
+    {
+        JobKind kind;
+        std::string data;       /**< Lines of a frame, or the name of a file to open */
+    };
+
+    /* Queues a job, returning its sequence number */
+    std::uint64_t Enqueue(JobKind kind, std::string data);
+    void Wait(std::uint64_t sequence);
+    void QueueFrame();
+
+    void Run();
+    void WriteFrame(const std::string& lines);
+    void Finish();
+
+    FileCompression _codec;
+    int _level;
+    std::size_t _frameSize;
+    std::string _frame;                     /**< Frame being filled by the caller */
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup;        /**< Signals the writer thread */
+    std::condition_variable _done;          /**< Signals callers once a job has completed or a slot is free */
+    std::deque<Job> _queue;
+    std::vector<std::string> _free;         /**< Recycled frame buffers */
+    std::uint64_t _queued {0};
+    std::uint64_t _completed {0};
+    bool _stopped {false};
+
+    /* Owned by the writer thread */
+    std::ofstream _file;
+    std::string _compressed;
+    std::uint64_t _offset {0};              /**< Bytes written into the current file */
+    std::uint64_t _rawOffset {0};           /**< Uncompressed bytes written into the current file */
+    std::vector<compressed_log::FrameEntry> _index;
+
+    std::thread _thread;
+};
+
+CXLOG_NAMESPACE_END
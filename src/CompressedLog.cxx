@@ -0,0 +1,112 @@
+#include "cxlog/CompressedLog.hpp"
+#include "Compression.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+static_assert(std::is_trivially_copyable_v<compressed_log::FrameEntry>, "Frame entries are stored as they are");
+
+CompressedLogReader::CompressedLogReader(const std::filesystem::path& path)
+    : _file(path, std::ios::binary)
+{
+    using namespace compressed_log;
+
+    if (!_file)
+        throw std::runtime_error("Unable to open compressed log " + path.string());
+
+    FileHeader header {};
+    if (!_file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0
+        || header.codec == static_cast<std::uint8_t>(FileCompression::None)
+        || header.codec > static_cast<std::uint8_t>(FileCompression::Zstd))
+        throw std::runtime_error("Not a compressed log " + path.string());
+
+    _codec = static_cast<FileCompression>(header.codec);
+
+    _file.seekg(0, std::ios::end);
+    auto size = static_cast<std::uint64_t>(_file.tellg());
+
+    /* Index written when the file was closed */
+    IndexFooter footer {};
+    if (size >= sizeof(FileHeader) + sizeof(IndexFooter))
+    {
+        _file.seekg(static_cast<std::streamoff>(size - sizeof(footer)));
+        if (_file.read(reinterpret_cast<char*>(&footer), sizeof(footer))
+            && std::memcmp(footer.magic, IndexMagic, sizeof(IndexMagic)) == 0
+            && footer.indexOffset >= sizeof(FileHeader)
+            && footer.count <= (size - sizeof(footer)) / sizeof(FrameEntry)
+            && footer.indexOffset + footer.count * sizeof(FrameEntry) + sizeof(footer) == size)
+        {
+            _frames.resize(footer.count);
+            _file.seekg(static_cast<std::streamoff>(footer.indexOffset));
+            _indexed = static_cast<bool>(_file.read(reinterpret_cast<char*>(_frames.data()),
+                                                    static_cast<std::streamsize>(footer.count * sizeof(FrameEntry))));
+        }
+        _file.clear();
+    }
+
+    if (_indexed)
+        return;
+
+    /* No index: walk the frames, up to the first incomplete one */
+    _frames.clear();
+    std::uint64_t offset = sizeof(FileHeader);
+    std::uint64_t rawOffset = 0;
+    FrameHeader frame {};
+
+    _file.seekg(static_cast<std::streamoff>(offset));
+    while (offset + sizeof(frame) <= size && _file.read(reinterpret_cast<char*>(&frame), sizeof(frame))
+           && frame.magic == FrameMagic && frame.size <= size - offset - sizeof(frame))
+    {
+        _frames.push_back({offset, rawOffset, frame.size, frame.rawSize});
+        offset += sizeof(frame) + frame.size;
+        rawOffset += frame.rawSize;
+        _file.seekg(static_cast<std::streamoff>(offset));
+    }
+    _file.clear();
+}
+
+std::string CompressedLogReader::ReadFrame(std::size_t frame)
+{
+    using namespace compressed_log;
+
+    const auto& entry = _frames.at(frame);
+
+    FrameHeader header {};
+    std::string payload(entry.size, '\0');
+
+    _file.clear();
+    _file.seekg(static_cast<std::streamoff>(entry.offset));
+    if (!_file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || header.magic != FrameMagic || header.size != entry.size || header.rawSize != entry.rawSize
+        || !_file.read(payload.data(), static_cast<std::streamsize>(payload.size())))
+        throw std::runtime_error("Corrupt frame " + std::to_string(frame) + " of compressed log");
+
+    if (header.flags & FrameStored)
+    {
+        if (header.size != header.rawSize)
+            throw std::runtime_error("Corrupt frame " + std::to_string(frame) + " of compressed log");
+        return payload;
+    }
+
+    std::string lines(header.rawSize, '\0');
+    if (!details::Decompress(_codec, payload, lines.data(), lines.size()))
+        throw std::runtime_error("Corrupt frame " + std::to_string(frame) + " of compressed log");
+
+    return lines;
+}
+
+std::string CompressedLogReader::ReadAll()
+{
+    std::string log;
+    for (std::size_t frame = 0; frame < _frames.size(); ++frame)
+        log += ReadFrame(frame);
+    return log;
+}
+
+CXLOG_NAMESPACE_END
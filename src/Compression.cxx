@@ -0,0 +1,270 @@
+#include "Compression.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef CXLOG_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef CXLOG_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+
+CXLOG_NAMESPACE_BEGIN
+
+namespace
+{
+    /*
+     * Built-in codec: LZ77 over a 64 KiB window, in sequences of
+     *   token (literal count << 4 | match length - 4), [extra literal count], literals, offset (2 bytes LE),
+     *   [extra match length]
+     * where a nibble of 15 is followed by extra bytes of 255 and a final byte below it, summed. The last sequence has
+     * literals only, and ends the input.
+     */
+    constexpr std::size_t MinMatch = 4;
+    constexpr std::size_t MaxOffset = 65535;
+    constexpr std::size_t TailLiterals = 5;      /* Matches stop short of the end, keeping the decoder simple */
+    constexpr int HashBits = 14;
+
+    std::uint32_t Load32(const char* p) noexcept
+    {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    std::uint32_t Hash(std::uint32_t value) noexcept
+    {
+        return (value * 2654435761u) >> (32 - HashBits);
+    }
+
+    char* PutLength(char* out, std::size_t length) noexcept
+    {
+        for (; length >= 255; length -= 255)
+            *out++ = static_cast<char>(255);
+        *out++ = static_cast<char>(length);
+        return out;
+    }
+
+    char* PutSequence(char* out, const char* literals, std::size_t literalCount, std::size_t offset,
+                      std::size_t matchLength) noexcept
+    {
+        auto literalNibble = literalCount < 15 ? literalCount : 15;
+        auto matchNibble = matchLength == 0 ? 0 : (matchLength - MinMatch < 15 ? matchLength - MinMatch : 15);
+
+        *out++ = static_cast<char>(literalNibble << 4 | matchNibble);
+        if (literalNibble == 15)
+            out = PutLength(out, literalCount - 15);
+
+        std::memcpy(out, literals, literalCount);
+        out += literalCount;
+
+        if (matchLength == 0)
+            return out;
+
+        *out++ = static_cast<char>(offset & 0xff);
+        *out++ = static_cast<char>(offset >> 8);
+        if (matchNibble == 15)
+            out = PutLength(out, matchLength - MinMatch - 15);
+        return out;
+    }
+
+    std::size_t LzBound(std::size_t size) noexcept
+    {
+        return size + size / 255 + 16;
+    }
+
+    std::size_t LzCompress(std::string_view data, char* out) noexcept
+    {
+        thread_local std::vector<std::uint32_t> table;
+        table.assign(std::size_t(1) << HashBits, 0);
+
+        const char* in = data.data();
+        auto size = data.size();
+        auto start = out;
+        std::size_t anchor = 0;
+        std::size_t pos = 0;
+
+        while (size >= MinMatch + TailLiterals && pos + MinMatch + TailLiterals <= size)
+        {
+            auto sequence = Load32(in + pos);
+            auto& slot = table[Hash(sequence)];
+            std::size_t candidate = slot;
+            slot = static_cast<std::uint32_t>(pos);
+
+            if (candidate >= pos || pos - candidate > MaxOffset || Load32(in + candidate) != sequence)
+            {
+                /* Step up over incompressible runs */
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+
+            auto length = MinMatch;
+            while (pos + length < size - TailLiterals && in[candidate + length] == in[pos + length])
+                ++length;
+
+            out = PutSequence(out, in + anchor, pos - anchor, pos - candidate, length);
+            pos += length;
+            anchor = pos;
+        }
+
+        out = PutSequence(out, in + anchor, size - anchor, 0, 0);
+        return static_cast<std::size_t>(out - start);
+    }
+
+    bool GetLength(const unsigned char* in, std::size_t size, std::size_t& pos, std::size_t& length) noexcept
+    {
+        while (true)
+        {
+            if (pos >= size)
+                return false;
+            auto byte = in[pos++];
+            length += byte;
+            if (byte != 255)
+                return true;
+        }
+    }
+
+    bool LzDecompress(std::string_view data, char* out, std::size_t rawSize) noexcept
+    {
+        auto in = reinterpret_cast<const unsigned char*>(data.data());
+        auto size = data.size();
+        std::size_t pos = 0;
+        std::size_t written = 0;
+
+        while (pos < size)
+        {
+            auto token = in[pos++];
+
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !GetLength(in, size, pos, literals))
+                return false;
+            if (literals > size - pos || literals > rawSize - written)
+                return false;
+
+            std::memcpy(out + written, in + pos, literals);
+            pos += literals;
+            written += literals;
+
+            if (pos == size)
+                break;
+
+            if (size - pos < 2)
+                return false;
+            std::size_t offset = in[pos] | std::size_t(in[pos + 1]) << 8;
+            pos += 2;
+
+            std::size_t length = (token & 15) + MinMatch;
+            if ((token & 15) == 15 && !GetLength(in, size, pos, length))
+                return false;
+            if (offset == 0 || offset > written || length > rawSize - written)
+                return false;
+
+            /* Overlapping copies repeat the last offset bytes */
+            auto from = out + written - offset;
+            for (std::size_t i = 0; i < length; ++i)
+                out[written + i] = from[i];
+            written += length;
+        }
+
+        return written == rawSize;
+    }
+}
+
+namespace details
+{
+    FileCompression AvailableCodec(FileCompression codec) noexcept
+    {
+        switch (codec)
+        {
+#ifdef CXLOG_HAVE_ZLIB
+            case FileCompression::Zlib:
+#endif
+#ifdef CXLOG_HAVE_ZSTD
+            case FileCompression::Zstd:
+#endif
+            case FileCompression::None:
+            case FileCompression::Lz:
+                return codec;
+            default:
+                return FileCompression::Lz;
+        }
+    }
+
+    std::size_t CompressBound(FileCompression codec, std::size_t size) noexcept
+    {
+        switch (codec)
+        {
+#ifdef CXLOG_HAVE_ZLIB
+            case FileCompression::Zlib:
+                return compressBound(static_cast<uLong>(size));
+#endif
+#ifdef CXLOG_HAVE_ZSTD
+            case FileCompression::Zstd:
+                return ZSTD_compressBound(size);
+#endif
+            default:
+                return LzBound(size);
+        }
+    }
+
+    std::size_t Compress(FileCompression codec, int level, std::string_view data, char* out) noexcept
+    {
+        switch (codec)
+        {
+#ifdef CXLOG_HAVE_ZLIB
+            case FileCompression::Zlib:
+            {
+                auto size = compressBound(static_cast<uLong>(data.size()));
+                auto result = compress2(reinterpret_cast<Bytef*>(out), &size,
+                                        reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()),
+                                        level == 0 ? Z_DEFAULT_COMPRESSION : level);
+                return result == Z_OK ? size : 0;
+            }
+#endif
+#ifdef CXLOG_HAVE_ZSTD
+            case FileCompression::Zstd:
+            {
+                auto size = ZSTD_compress(out, ZSTD_compressBound(data.size()), data.data(), data.size(), level);
+                return ZSTD_isError(size) ? 0 : size;
+            }
+#endif
+            case FileCompression::Lz:
+                return LzCompress(data, out);
+            default:
+                return 0;
+        }
+    }
+
+    bool Decompress(FileCompression codec, std::string_view data, char* out, std::size_t rawSize) noexcept
+    {
+        switch (codec)
+        {
+#ifdef CXLOG_HAVE_ZLIB
+            case FileCompression::Zlib:
+            {
+                auto size = static_cast<uLongf>(rawSize);
+                auto result = uncompress(reinterpret_cast<Bytef*>(out), &size,
+                                         reinterpret_cast<const Bytef*>(data.data()), static_cast<uLong>(data.size()));
+                return result == Z_OK && size == rawSize;
+            }
+#endif
+#ifdef CXLOG_HAVE_ZSTD
+            case FileCompression::Zstd:
+            {
+                auto size = ZSTD_decompress(out, rawSize, data.data(), data.size());
+                return !ZSTD_isError(size) && size == rawSize;
+            }
+#endif
+            case FileCompression::Lz:
+                return LzDecompress(data, out, rawSize);
+            default:
+                return false;
+        }
+    }
+}
+
+CXLOG_NAMESPACE_END
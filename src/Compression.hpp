@@ -0,0 +1,36 @@
+#pragma once
+#include "cxlog/defs.hpp"
+#include "cxlog/CompressedLog.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+CXLOG_NAMESPACE_BEGIN
+
+namespace details
+{
+    /**
+     * @return Codec used for the requested one: Zlib and Zstd become Lz unless cxlog has been built with them
+     */
+    FileCompression AvailableCodec(FileCompression codec) noexcept;
+
+    /**
+     * @return Largest compressed size of size bytes
+     */
+    std::size_t CompressBound(FileCompression codec, std::size_t size) noexcept;
+
+    /**
+     * @brief Compresses data into out, which has room for CompressBound() bytes
+     * @param level Codec specific level, 0 for the codec's default
+     * @return Compressed size, 0 on failure
+     */
+    std::size_t Compress(FileCompression codec, int level, std::string_view data, char* out) noexcept;
+
+    /**
+     * @brief Decompresses exactly rawSize bytes into out
+     * @return false if data is corrupt or doesn't decompress to rawSize bytes
+     */
+    bool Decompress(FileCompression codec, std::string_view data, char* out, std::size_t rawSize) noexcept;
+}
+
+CXLOG_NAMESPACE_END
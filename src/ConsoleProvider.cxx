@@ -1,7 +1,6 @@
 #include <string>
 #include <iostream>
 #include <utility>
-#include <sstream>
 
 #ifdef __ANDROID__
 #include <android/log.h>
@@ -16,27 +15,31 @@ using namespace cxlog;
 class ConsoleLogger : public cxlog::ILogger
 {
 public:
-    ConsoleLogger(std::string name, std::ostream& target, LogLevel minLevel)
+    ConsoleLogger(std::string name, std::ostream& target, LogLevel minLevel, std::string_view pattern)
         : _name(std::move(name))
         , _target(target)
         , _minLevel(minLevel)
+        , _formatter(pattern, _name)
     {
     }
 
-    void Log(LogLevel level, const std::string& message) override
+    void Log(LogLevel level, std::string_view message) override
     {
-        std::ostringstream ss;
+        Log(LogRecord::Make(level, _name, message));
+    }
 
-        ss << "[" << to_string(level) << "] " << _name << ": " << message << "\n";
+    void Log(const LogRecord& record) override
+    {
+        auto line = record.Render(_formatter);
 
 #ifdef __ANDROID__
         if (&_target == &std::cout)
         {
-            auto str = ss.str();
-            __android_log_write(LogLevelToAndroidLevel(level), _name.c_str(), str.c_str());
+            /* Rendered line lives in a std::string buffer, so it is always null terminated */
+            __android_log_write(LogLevelToAndroidLevel(record.Level), _name.c_str(), line.data());
         }
 #else
-        _target << ss.str();
+        _target.write(line.data(), static_cast<std::streamsize>(line.size()));
 #endif /* __ANDROID__ */
     }
 
@@ -46,10 +49,17 @@ public:
         return level >= _minLevel;
     }
 
+    [[nodiscard]]
+    std::size_t MemoryUsage() const noexcept override
+    {
+        return sizeof(*this) + _name.capacity() + _formatter.MemoryUsage();
+    }
+
 private:
     const std::string _name;
     std::ostream& _target;
     LogLevel _minLevel;
+    PatternFormatter _formatter;
 
 #ifdef __ANDROID__
     static int LogLevelToAndroidLevel(LogLevel level)
@@ -66,9 +76,10 @@ private:
 #endif /* __ANDROID__ */
 };
 
-ConsoleProvider::ConsoleProvider(std::ostream &target, LogLevel minLevel)
+ConsoleProvider::ConsoleProvider(std::ostream &target, LogLevel minLevel, std::string_view pattern)
     : _target(target)
     , _minLevel(minLevel)
+    , _pattern(pattern)
 {
 }
 
@@ -77,12 +88,23 @@ std::shared_ptr<ILogger> ConsoleProvider::GetLogger(const std::string& name)
     auto& l = _loggers[name];
     if (!l)
     {
-        l = std::make_shared<ConsoleLogger>(name, _target, _minLevel);
+        l = std::make_shared<ConsoleLogger>(name, _target, _minLevel, _pattern);
     }
 
     return l;
 }
 
+void ConsoleProvider::ReleaseLogger(const std::string& name)
+{
+    _loggers.erase(name);
+}
+
+std::future<void> ConsoleProvider::Flush()
+{
+    _target.flush();
+    return details::ReadyFuture();
+}
+
 std::string_view ConsoleProvider::GetName() const
 {
     return "ConsoleProvider";
@@ -0,0 +1,260 @@
+#include "cxlog/DaemonProvider.hpp"
+#include "cxlog/DaemonProtocol.hpp"
+#include "cxlog/MessageArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+struct DaemonProvider::SharedData
+{
+    DaemonProviderOptions opt;                      /**< Provider options */
+
+    std::mutex mutex;                               /**< Guards everything below */
+    std::condition_variable wakeup;
+    std::string batch;                              /**< Batch being filled */
+    std::uint16_t count {0};                        /**< Records in the batch */
+    int fd {-1};                                    /**< Connection to the daemon */
+    std::chrono::steady_clock::time_point nextConnect;  /**< Earliest time of the next connection attempt */
+    bool stopped {false};
+
+    std::atomic<std::uint64_t> dropped {0};
+    std::thread flusher;                            /**< Sends partially filled batches */
+
+    explicit SharedData(DaemonProviderOptions options) : opt(std::move(options))
+    {
+        batch.reserve(opt.batchSize);
+        daemon_protocol::BeginBatch(batch);
+        flusher = std::thread([this] { Run(); });
+    }
+
+    ~SharedData()
+    {
+        Stop();
+    }
+
+    void Append(const LogRecord& record, std::string_view category)
+    {
+        using namespace daemon_protocol;
+
+        /* A single record must fit into a batch on its own */
+        auto limit = opt.batchSize - sizeof(BatchHeader) - sizeof(RecordHeader);
+        category = category.substr(0, std::min<std::size_t>(limit, 0xffff));
+        auto message = record.Message.substr(0, limit - category.size());
+
+        RecordHeader header {};
+        header.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(record.Timestamp.time_since_epoch()).count();
+        header.threadId = record.ThreadId;
+        header.messageLength = static_cast<std::uint32_t>(message.size());
+        header.categoryLength = static_cast<std::uint16_t>(category.size());
+        header.level = static_cast<std::uint8_t>(record.Level);
+
+        std::lock_guard lock(mutex);
+        if (stopped)
+            return;
+
+        if (batch.size() + sizeof(header) + category.size() + message.size() > opt.batchSize || count == 0xffff)
+            Send();
+
+        AppendRecord(batch, header, category, message);
+        ++count;
+
+        if (batch.size() >= opt.batchSize)
+            Send();
+    }
+
+    /* Sends the current batch without blocking, dropping it if the daemon can't take it. Called with mutex held. */
+    void Send()
+    {
+        if (count == 0)
+            return;
+
+        if (fd < 0)
+            Connect();
+
+        if (fd < 0 || ::send(fd, batch.data(), batch.size(), MSG_DONTWAIT | MSG_NOSIGNAL) < 0)
+        {
+            if (fd >= 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+            dropped.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        daemon_protocol::BeginBatch(batch);
+        count = 0;
+    }
+
+    /* Connects to the daemon, at most once a second. Called with mutex held. */
+    void Connect()
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextConnect)
+            return;
+        nextConnect = now + std::chrono::seconds(1);
+
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        if (opt.socketPath.size() >= sizeof(address.sun_path))
+            return;
+        std::copy(opt.socketPath.begin(), opt.socketPath.end(), address.sun_path);
+
+        fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return;
+
+        /* Let a burst of batches queue up while the daemon catches up, instead of dropping them */
+        int bufferSize = static_cast<int>(std::min<std::size_t>(opt.batchSize * 64, 4 * 1024 * 1024));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    void Flush()
+    {
+        std::lock_guard lock(mutex);
+        Send();
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard lock(mutex);
+            if (stopped)
+                return;
+
+            Send();
+            stopped = true;
+            if (fd >= 0)
+                ::close(fd);
+            fd = -1;
+        }
+
+        wakeup.notify_all();
+        if (flusher.joinable())
+            flusher.join();
+    }
+
+    void Run()
+    {
+        std::unique_lock lock(mutex);
+        while (!stopped)
+        {
+            wakeup.wait_for(lock, opt.flushInterval);
+            if (!stopped)
+            {
+                details::AllowAllocations allow;
+                Send();
+            }
+        }
+    }
+};
+
+class DaemonLogger : public ILogger
+{
+public:
+    DaemonLogger(std::string name, std::shared_ptr<DaemonProvider::SharedData> data)
+        : _name(std::move(name)), _sharedData(std::move(data))
+    {
+    }
+
+    void Log(LogLevel level, std::string_view message) override
+    {
+        Log(LogRecord::Make(level, _name, message));
+    }
+
+    void Log(const LogRecord& record) override
+    {
+        if (!IsEnabled(record.Level))
+            return;
+
+        _sharedData->Append(record, _name);
+    }
+
+    [[nodiscard]] bool IsEnabled(LogLevel level) const noexcept override
+    {
+        return level >= _sharedData->opt.minLevel;
+    }
+
+    [[nodiscard]] std::size_t MemoryUsage() const noexcept override
+    {
+        return sizeof(*this) + _name.capacity();
+    }
+
+private:
+    std::string _name;                                          /**< Logger name */
+    std::shared_ptr<DaemonProvider::SharedData> _sharedData;    /**< Connection shared by all loggers of the provider */
+};
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+DaemonProvider::DaemonProvider(DaemonProviderOptions opt)
+{
+    using namespace daemon_protocol;
+
+    if (opt.batchSize < sizeof(BatchHeader) + sizeof(RecordHeader) + 256)
+        throw std::invalid_argument("DaemonProvider: batchSize is too small");
+    if (opt.batchSize > MaxBatchSize)
+        throw std::invalid_argument("DaemonProvider: batchSize exceeds daemon_protocol::MaxBatchSize");
+
+    _providerData = std::make_shared<SharedData>(std::move(opt));
+}
+
+DaemonProvider::~DaemonProvider() = default;
+
+std::shared_ptr<ILogger> DaemonProvider::GetLogger(const std::string& name)
+{
+    auto& l = _loggers[name];
+    if (!l)
+    {
+        l = std::make_shared<DaemonLogger>(name, _providerData);
+    }
+
+    return l;
+}
+
+void DaemonProvider::ReleaseLogger(const std::string& name)
+{
+    _loggers.erase(name);
+}
+
+std::string_view DaemonProvider::GetName() const
+{
+    return "DaemonProvider";
+}
+
+std::future<void> DaemonProvider::Flush()
+{
+    _providerData->Flush();
+    return details::ReadyFuture();
+}
+
+std::future<void> DaemonProvider::Shutdown(std::chrono::steady_clock::time_point)
+{
+    _providerData->Stop();
+    return details::ReadyFuture();
+}
+
+std::uint64_t DaemonProvider::Dropped() const noexcept
+{
+    return _providerData->dropped.load(std::memory_order_relaxed);
+}
+
+CXLOG_NAMESPACE_END
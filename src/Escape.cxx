@@ -0,0 +1,168 @@
+#include "cxlog/Escape.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CXLOG_ESCAPE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(CXLOG_ESCAPE_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CXLOG_ESCAPE_AVX2 1
+#include <immintrin.h>
+#endif
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+static bool NeedsEscape(unsigned char c, EscapeMode mode) noexcept
+{
+    if (mode == EscapeMode::Json)
+        return c < 0x20 || c == '"' || c == '\\';
+
+    return (c < 0x20 && c != '\t') || c == 0x7f;
+}
+
+static std::size_t FindEscapeScalar(const char* data, std::size_t pos, std::size_t size, EscapeMode mode) noexcept
+{
+    for (; pos < size; ++pos)
+    {
+        if (NeedsEscape(static_cast<unsigned char>(data[pos]), mode))
+            return pos;
+    }
+    return size;
+}
+
+#if defined(CXLOG_ESCAPE_SSE2)
+
+static int FirstBit(unsigned mask) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CXLOG_ALWAYS_INLINE __forceinline
+#else
+#define CXLOG_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+/* Inlined into the AVX2 scanner as well, where it is VEX encoded and so avoids SSE/AVX transition stalls */
+static CXLOG_ALWAYS_INLINE std::size_t FindEscapeSse2Inline(const char* data, std::size_t pos, std::size_t size,
+                                                            EscapeMode mode) noexcept
+{
+    /* Unsigned c < 0x20 is c == min(c, 0x1f); there are no unsigned byte compares in SSE2 */
+    const auto control = _mm_set1_epi8(0x1f);
+    const auto first = _mm_set1_epi8(mode == EscapeMode::Json ? '"' : 0x7f);
+    const auto second = _mm_set1_epi8(mode == EscapeMode::Json ? '\\' : 0x7f);
+    const auto allowed = _mm_set1_epi8(mode == EscapeMode::Json ? ' ' : '\t');      /* Control byte left as is; none for JSON */
+
+    for (; pos + 16 <= size; pos += 16)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        auto low = _mm_andnot_si128(_mm_cmpeq_epi8(v, allowed), _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        auto hits = _mm_or_si128(low, _mm_or_si128(_mm_cmpeq_epi8(v, first), _mm_cmpeq_epi8(v, second)));
+
+        if (auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits)))
+            return pos + FirstBit(mask);
+    }
+    return FindEscapeScalar(data, pos, size, mode);
+}
+
+static std::size_t FindEscapeSse2(const char* data, std::size_t pos, std::size_t size, EscapeMode mode) noexcept
+{
+    return FindEscapeSse2Inline(data, pos, size, mode);
+}
+
+#endif
+
+#if defined(CXLOG_ESCAPE_AVX2)
+
+__attribute__((target("avx2")))
+static std::size_t FindEscapeAvx2(const char* data, std::size_t pos, std::size_t size, EscapeMode mode) noexcept
+{
+    const auto control = _mm256_set1_epi8(0x1f);
+    const auto first = _mm256_set1_epi8(mode == EscapeMode::Json ? '"' : 0x7f);
+    const auto second = _mm256_set1_epi8(mode == EscapeMode::Json ? '\\' : 0x7f);
+    const auto allowed = _mm256_set1_epi8(mode == EscapeMode::Json ? ' ' : '\t');
+
+    for (; pos + 32 <= size; pos += 32)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        auto low = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, allowed), _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+        auto hits = _mm256_or_si256(low, _mm256_or_si256(_mm256_cmpeq_epi8(v, first), _mm256_cmpeq_epi8(v, second)));
+
+        if (auto mask = static_cast<unsigned>(_mm256_movemask_epi8(hits)))
+            return pos + __builtin_ctz(mask);
+    }
+    return FindEscapeSse2Inline(data, pos, size, mode);
+}
+
+#endif
+
+using FindEscapeFn = std::size_t (*)(const char*, std::size_t, std::size_t, EscapeMode) noexcept;
+
+/* Widest scanner supported by the CPU, selected once */
+static FindEscapeFn SelectFindEscape() noexcept
+{
+#if defined(CXLOG_ESCAPE_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return FindEscapeAvx2;
+#endif
+#if defined(CXLOG_ESCAPE_SSE2)
+    return FindEscapeSse2;
+#else
+    return FindEscapeScalar;
+#endif
+}
+
+static const FindEscapeFn findEscape = SelectFindEscape();
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+std::size_t FindEscape(std::string_view text, EscapeMode mode) noexcept
+{
+    /* Static initializers of other units may log before findEscape is set */
+    auto fn = findEscape ? findEscape : FindEscapeScalar;
+    return fn(text.data(), 0, text.size(), mode);
+}
+
+void AppendEscaped(std::string& out, std::string_view text, EscapeMode mode)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    auto fn = findEscape ? findEscape : FindEscapeScalar;
+    std::size_t pos = 0;
+    while (pos < text.size())
+    {
+        auto next = fn(text.data(), pos, text.size(), mode);
+        out.append(text.data() + pos, next - pos);
+        if (next == text.size())
+            break;
+
+        auto c = static_cast<unsigned char>(text[next]);
+        switch (c)
+        {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                out.append(mode == EscapeMode::Json ? "\\u00" : "\\x");
+                out.push_back(hex[c >> 4]);
+                out.push_back(hex[c & 0xf]);
+                break;
+        }
+        pos = next + 1;
+    }
+}
+
+CXLOG_NAMESPACE_END
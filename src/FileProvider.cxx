@@ -4,15 +4,38 @@
 #include <ctime>
 #include <algorithm>
 #include <fstream>
-#include <sstream>
+#include <atomic>
+#include <mutex>
 
 #include "cxlog/FileProvider.hpp"
+#include "cxlog/LogIndex.hpp"
+#include "cxlog/MessageArena.hpp"
+
+#include "CompressedFile.hpp"
+#include "Compression.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <condition_variable>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef CXLOG_IO_URING
+#include "UringFile.hpp"
+#endif
 
 
 CXLOG_NAMESPACE_BEGIN
 
 
-static std::string MakeFileName(const std::filesystem::path& base)
+static std::string MakeFileName(const std::filesystem::path& base, std::string_view extension = ".log")
 {
     std::time_t time = std::time({});
     char timeString[std::size("yyyy-mm-ddThh:mm:ssZ")];
@@ -25,7 +48,7 @@ static std::string MakeFileName(const std::filesystem::path& base)
     std::string filename;
 
     do {
-        filename = std::string(timeString) + (n == 0 ? "" : ("-" + std::to_string(n))) + ".log";
+        filename = std::string(timeString) + (n == 0 ? "" : ("-" + std::to_string(n))) + std::string(extension);
         ++n;
     } while (std::filesystem::exists(base / filename));
 
@@ -33,40 +56,613 @@ static std::string MakeFileName(const std::filesystem::path& base)
 }
 
 
+/* Frame sizes are stored in 32 bits, and a frame may run over by a line */
+static constexpr std::size_t MaxCompressionFrameSize = 64 * 1024 * 1024;
+
+
+#ifndef _WIN32
+static constexpr const char* SharedFileName = "current.log";
+static constexpr const char* SharedLockName = "cxlog.lock";
+
+/* Rotation state of a shared directory, mapped by every process appending to it. Starts zeroed. */
+struct SharedFileState
+{
+    std::atomic<std::uint64_t> generation;  /**< Incremented by every rotation */
+    std::atomic<std::int64_t> messages;     /**< Messages written into current.log */
+    std::atomic<std::int32_t> day;          /**< Day of month current.log has been started on */
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared state atomics must be address free");
+
+
+/*
+ * Syncs the current file on its own thread. Every durable record bumps the requested count after it has been handed
+ * to the kernel; a sync started afterwards covers it, along with all other records requested until the sync starts.
+ */
+class GroupCommitter
+{
+public:
+    explicit GroupCommitter(std::chrono::microseconds window) : _window(window), _thread([this] { Run(); })
+    {
+    }
+
+    ~GroupCommitter()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stopped = true;
+        }
+        _wakeup.notify_all();
+        _thread.join();
+
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+    /* Switches to a new file once the old one has been committed. Takes ownership of fd. */
+    void SetFile(int fd)
+    {
+        std::unique_lock lock(_mutex);
+        _done.wait(lock, [&] { return !_syncing; });
+
+        if (_requested > _committed)
+        {
+            Sync(_fd);
+            _committed = _requested;
+            _done.notify_all();
+        }
+
+        if (_fd >= 0)
+            ::close(_fd);
+        _fd = fd;
+    }
+
+    void Request()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            ++_requested;
+        }
+        _wakeup.notify_one();
+    }
+
+    bool Wait(std::chrono::steady_clock::time_point deadline)
+    {
+        std::unique_lock lock(_mutex);
+        auto target = _requested;
+        auto committed = [&] { return _committed >= target; };
+
+        if (deadline == std::chrono::steady_clock::time_point::max())
+        {
+            _done.wait(lock, committed);
+            return true;
+        }
+        return _done.wait_until(lock, deadline, committed);
+    }
+
+private:
+    static void Sync(int fd) noexcept
+    {
+        if (fd < 0)
+            return;
+#ifdef __APPLE__
+        ::fsync(fd);
+#else
+        ::fdatasync(fd);
+#endif
+    }
+
+    void Run()
+    {
+        std::unique_lock lock(_mutex);
+        while (true)
+        {
+            _wakeup.wait(lock, [&] { return _stopped || _requested > _committed; });
+            if (_requested == _committed)
+                break;
+
+            /* Let records of the window join this commit */
+            if (_window.count() > 0)
+                _wakeup.wait_for(lock, _window, [&] { return _stopped; });
+
+            auto target = _requested;
+            auto fd = _fd;
+            _syncing = true;
+
+            lock.unlock();
+            Sync(fd);
+            lock.lock();
+
+            _syncing = false;
+            _committed = std::max(_committed, target);
+            _done.notify_all();
+        }
+    }
+
+    std::chrono::microseconds _window;
+    std::mutex _mutex;
+    std::condition_variable _wakeup;        /**< Signals the committer thread */
+    std::condition_variable _done;          /**< Signals waiters once a sync has completed */
+    int _fd {-1};                           /**< Read only descriptor of the current file */
+    std::uint64_t _requested {0};           /**< Durable records handed to the kernel */
+    std::uint64_t _committed {0};           /**< Durable records synced */
+    bool _syncing {false};
+    bool _stopped {false};
+    std::thread _thread;
+};
+#endif
+
+
 struct FileProvider::SharedData
 {
     std::filesystem::path path;       /**< Basename to use for log files */
     FileProviderOptions opt;          /**< Provider options */
 
+    std::mutex mutex;                 /**< Held by loggers, Flush() and Shutdown() while using everything below */
     std::ofstream file;               /**< File stream to write logs to */
     int messageCounter;               /**< Counter to use for log messages */
     int lastMessageDay;               /**< Day of month of last logged message */
+    std::atomic<bool> closed {false}; /**< Set once the provider has been shut down */
+
+    std::ofstream index;              /**< Sidecar index of the current file, if enabled */
+    LogIndexEntry block;              /**< Index entry of the block being written */
+    std::uint64_t offset {0};         /**< Bytes written into the current file */
+
+#ifndef _WIN32
+    int fd {-1};                      /**< current.log, in shared mode */
+    int lockFd {-1};                  /**< cxlog.lock, in shared mode */
+    SharedFileState* state {nullptr}; /**< Mapped cxlog.lock */
+    std::uint64_t generation {0};     /**< Rotation fd belongs to */
+    std::string pending;              /**< Lines waiting to be written, see FileProviderOptions::sharedBatchSize */
+#endif
+
+#ifndef _WIN32
+    std::shared_ptr<GroupCommitter> committer;  /**< Set with FileDurability::GroupCommit */
+    pid_t committerPid {0};                     /**< Process the committer thread runs in */
+    std::filesystem::path committedName;        /**< File the committer syncs */
+#endif
+
+    std::unique_ptr<CompressedFile> compressed; /**< Set with compression */
+
+#ifdef CXLOG_IO_URING
+    std::unique_ptr<UringFile> uring; /**< Set when writing through io_uring */
+    int uringFd {-1};                 /**< File written through uring */
+#endif
+
+    ~SharedData()
+    {
+        FinishBlock();
+        CloseShared();
+        CloseUring();
+        compressed.reset();
+        CloseCommitter();
+    }
+
+    /* Starts a new log file, along with its index */
+    void Open()
+    {
+        FinishBlock();
+
+        if (opt.compression != FileCompression::None)
+        {
+            auto name = path / MakeFileName(path, ".log.cxz");
+            if (!compressed)
+                compressed = std::make_unique<CompressedFile>(opt.compression, opt.compressionLevel,
+                                                              opt.compressionFrameSize);
+            compressed->Open(name);
+            AttachCommitter(name);
+            return;
+        }
+
+        auto name = path / MakeFileName(path);
+        if (!OpenUring(name))
+            file = std::ofstream(name);
+        AttachCommitter(name);
+        offset = 0;
+        block = LogIndexEntry{};
+
+        if (opt.index)
+        {
+            index = std::ofstream(LogIndexPath(name), std::ios::binary);
+            index.write(LogIndexEntry::Magic, sizeof(LogIndexEntry::Magic));
+        }
+    }
+
+    /* Appends a rendered line, accounting for it in the index */
+    void Write(const LogRecord& record, std::string_view line, const std::array<std::uint64_t, 4>& bloom)
+    {
+        if (compressed)
+        {
+            compressed->Write(line);
+            return;
+        }
+
+#ifdef CXLOG_IO_URING
+        if (uring)
+            uring->Write(line);
+        else
+#endif
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+        offset += line.size();
+
+        if (opt.index)
+        {
+            block.Add(record.Level, record.Timestamp, bloom, line.size());
+            if (block.Length >= opt.indexBlockSize)
+                FinishBlock();
+        }
+    }
+
+#ifndef _WIN32
+    void OpenShared()
+    {
+        auto lockPath = path / SharedLockName;
+        lockFd = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (lockFd < 0)
+            throw std::system_error(errno, std::generic_category(), "FileProvider: open " + lockPath.string());
+
+        /* Whoever comes first extends the file; zero filled state is valid */
+        struct stat st {};
+        ::flock(lockFd, LOCK_EX);
+        if (::fstat(lockFd, &st) != 0 || (static_cast<std::size_t>(st.st_size) < sizeof(SharedFileState)
+                                          && ::ftruncate(lockFd, sizeof(SharedFileState)) != 0))
+        {
+            auto error = errno;
+            ::flock(lockFd, LOCK_UN);
+            throw std::system_error(error, std::generic_category(), "FileProvider: ftruncate " + lockPath.string());
+        }
+        ::flock(lockFd, LOCK_UN);
+
+        void* memory = ::mmap(nullptr, sizeof(SharedFileState), PROT_READ | PROT_WRITE, MAP_SHARED, lockFd, 0);
+        if (memory == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "FileProvider: mmap " + lockPath.string());
+
+        state = static_cast<SharedFileState*>(memory);
+        Reopen();
+    }
+
+    void CloseShared()
+    {
+        if (!opt.shared)
+            return;
+
+        WritePending();
+        if (fd >= 0)
+            ::close(fd);
+        if (lockFd >= 0)
+            ::close(lockFd);
+        if (state)
+            ::munmap(state, sizeof(SharedFileState));
+
+        fd = lockFd = -1;
+        state = nullptr;
+    }
+
+    /* Opens current.log as of the latest rotation */
+    void Reopen()
+    {
+        generation = state->generation.load(std::memory_order_acquire);
+
+        auto name = path / SharedFileName;
+        int newFd = ::open(name.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (newFd < 0)
+            return;     /* keep writing into the previous file rather than losing lines */
+
+        if (fd >= 0)
+            ::close(fd);
+        fd = newFd;
+        AttachCommitter(name);
+    }
+
+    [[nodiscard]] bool RotationDue(int today) const noexcept
+    {
+        switch (opt.splitType)
+        {
+            case FileSplitType::NumMessages:
+                return state->messages.load(std::memory_order_relaxed) >= opt.messagesCount;
+            case FileSplitType::Daily:
+                return state->day.load(std::memory_order_relaxed) != today;
+            default:
+                return false;
+        }
+    }
+
+    /* Renames current.log to a timestamped name, unless another process has done so meanwhile */
+    void Rotate(int today)
+    {
+        WritePending();
+
+        ::flock(lockFd, LOCK_EX);
+        if (RotationDue(today))
+        {
+            struct stat st {};
+            auto name = path / SharedFileName;
+            if (::stat(name.c_str(), &st) == 0 && st.st_size > 0)
+                ::rename(name.c_str(), (path / MakeFileName(path)).c_str());
+
+            state->messages.store(0, std::memory_order_relaxed);
+            state->day.store(today, std::memory_order_relaxed);
+            state->generation.fetch_add(1, std::memory_order_release);
+        }
+        ::flock(lockFd, LOCK_UN);
+
+        Reopen();
+    }
+
+    /* Appends a rendered line in shared mode */
+    void Append(std::string_view line)
+    {
+        if (state->generation.load(std::memory_order_acquire) != generation)
+        {
+            WritePending();
+            Reopen();
+        }
+
+        int today = 0;
+        if (opt.splitType == FileSplitType::Daily)
+        {
+            auto tt = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+            today = std::localtime(&tt)->tm_mday;
+        }
+
+        if (RotationDue(today))
+        {
+            details::AllowAllocations allow;
+            Rotate(today);
+        }
+
+        if (opt.splitType == FileSplitType::NumMessages)
+            state->messages.fetch_add(1, std::memory_order_relaxed);
+
+        if (opt.sharedBatchSize == 0)
+        {
+            WriteAll(line);
+            return;
+        }
+
+        pending.append(line);
+        if (pending.size() >= opt.sharedBatchSize)
+            WritePending();
+    }
+
+    void WritePending()
+    {
+        if (pending.empty())
+            return;
+
+        WriteAll(pending);
+        pending.clear();
+    }
+
+    /* One write() per call keeps lines of different processes apart; a short write only happens on errors such as
+     * a full disk, in which case the rest is retried */
+    void WriteAll(std::string_view data) const noexcept
+    {
+        while (!data.empty())
+        {
+            auto written = ::write(fd, data.data(), data.size());
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return;
+            data.remove_prefix(static_cast<std::size_t>(written));
+        }
+    }
+    /* Gives the committer its own descriptor of a newly opened file */
+    void AttachCommitter(const std::filesystem::path& name)
+    {
+        if (opt.durability != FileDurability::GroupCommit)
+            return;
+
+        DropForkedCommitter();
+        if (!committer)
+        {
+            committer = std::make_shared<GroupCommitter>(opt.groupCommitWindow);
+            committerPid = ::getpid();
+        }
+        committer->SetFile(::open(name.c_str(), O_RDONLY | O_CLOEXEC));
+        committedName = name;
+    }
+
+    /* Restarts the committer in a process forked after it was started, which inherits no committer thread */
+    void RestartForkedCommitter()
+    {
+        if (DropForkedCommitter())
+            AttachCommitter(committedName);
+    }
+
+    /* Destroying the committer of the parent would join a thread which doesn't exist in this process, and its
+     * lock may have been held at the time of the fork; it is abandoned instead. */
+    bool DropForkedCommitter()
+    {
+        if (!committer || committerPid == ::getpid())
+            return false;
+
+        static_cast<void>(new std::shared_ptr<GroupCommitter>(std::move(committer)));
+        return true;
+    }
+
+    void CloseCommitter()
+    {
+        DropForkedCommitter();
+        committer.reset();
+    }
+
+    /* Applies the durability tier to a record which has just been written */
+    void Commit(LogLevel level)
+    {
+        if (opt.durability == FileDurability::None || level < opt.durableLevel)
+            return;
+
+        if (opt.shared)
+            WritePending();
+        else
+            FlushData();
+
+        RestartForkedCommitter();
+        if (committer)
+            committer->Request();
+    }
+
+    /* Waits without the mutex, so loggers aren't held up meanwhile */
+    bool WaitDurable(std::chrono::steady_clock::time_point deadline)
+    {
+        std::shared_ptr<GroupCommitter> current;
+        {
+            std::lock_guard lock(mutex);
+            RestartForkedCommitter();
+            current = committer;
+        }
+        return !current || current->Wait(deadline);
+    }
+#else
+    void AttachCommitter(const std::filesystem::path&) {}
+    void CloseCommitter() {}
+
+    void Commit(LogLevel level)
+    {
+        if (opt.durability != FileDurability::None && level >= opt.durableLevel)
+            FlushData();
+    }
+
+    bool WaitDurable(std::chrono::steady_clock::time_point) { return true; }
+
+    void OpenShared() { throw std::invalid_argument("FileProvider: shared mode is not supported on this platform"); }
+    void CloseShared() {}
+    void Append(std::string_view) {}
+    void WritePending() {}
+#endif
+
+#ifdef CXLOG_IO_URING
+    /* Opens the file for io_uring; false if the stream should be used instead */
+    bool OpenUring(const std::filesystem::path& name)
+    {
+        if (opt.backend != FileBackend::IoUring)
+            return false;
+
+        if (!uring)
+        {
+            uring = std::make_unique<UringFile>();
+            if (!uring->Open(opt.uringBufferSize, opt.uringBufferCount, opt.uringSync, opt.uringSqPoll))
+            {
+                /* Kernel without io_uring, or disabled by policy */
+                uring.reset();
+                opt.backend = FileBackend::Stream;
+                return false;
+            }
+        }
+
+        int fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        uring->SetFile(fd, 0);
+        if (uringFd >= 0)
+            ::close(uringFd);
+        uringFd = fd;
+        return true;
+    }
+
+    void CloseUring()
+    {
+        if (!uring)
+            return;
+
+        uring.reset();
+        if (uringFd >= 0)
+            ::close(uringFd);
+        uringFd = -1;
+    }
+
+    /* Hands buffered data to the kernel without waiting for it */
+    void SubmitData()
+    {
+        if (uring)
+            uring->Submit();
+        else
+            file.flush();
+    }
+
+    void FlushData()
+    {
+        if (compressed)
+            compressed->Flush();
+        else if (uring)
+            uring->Flush();
+        else
+            file.flush();
+    }
+#else
+    bool OpenUring(const std::filesystem::path&)
+    {
+        opt.backend = FileBackend::Stream;
+        return false;
+    }
+
+    void CloseUring() {}
+    void SubmitData() { file.flush(); }
+    void FlushData()
+    {
+        if (compressed)
+            compressed->Flush();
+        else
+            file.flush();
+    }
+#endif
+
+    /* Writes index entry of the current block, once all its lines have been written out */
+    void FinishBlock()
+    {
+        if (!opt.index || block.Lines == 0)
+            return;
+
+        SubmitData();
+        index.write(reinterpret_cast<const char*>(&block), sizeof(block));
+        index.flush();
+
+        block = LogIndexEntry{};
+        block.Offset = offset;
+    }
 };
 
 class FileLogger : public ILogger
 {
 public:
     FileLogger(std::string name, std::shared_ptr<FileProvider::SharedData> data)
-        : _name(std::move(name)), _sharedData(std::move(data))
+        : _name(std::move(name)), _sharedData(std::move(data)), _formatter(_sharedData->opt.pattern, _name)
+        , _bloom(LogIndexEntry::CategoryBloom(_name))
+    {
+    }
+
+    void Log(LogLevel level, std::string_view message) override
     {
+        Log(LogRecord::Make(level, _name, message));
     }
 
-    void Log(LogLevel level, const std::string& message) override
+    void Log(const LogRecord& record) override
     {
-        if (!IsEnabled(level))
+        if (!IsEnabled(record.Level) || _sharedData->closed.load(std::memory_order_acquire))
             return;
 
-        std::stringstream ss;
-        ss << "[" << to_string(level) << "] " << _name << ": " << message << "\n";
+        auto line = record.Render(_formatter);
+
+        /* Shutdown() may have closed the file since the check above */
+        std::lock_guard lock(_sharedData->mutex);
+        if (_sharedData->closed.load(std::memory_order_relaxed))
+            return;
+
+        if (_sharedData->opt.shared)
+        {
+            _sharedData->Append(line);
+            _sharedData->Commit(record.Level);
+            return;
+        }
 
         if (_sharedData->opt.splitType == FileSplitType::NumMessages)
         {
             if(++_sharedData->messageCounter > _sharedData->opt.messagesCount)
             {
+                details::AllowAllocations allow;
                 _sharedData->messageCounter = 0;
-                _sharedData->file.flush();
 
-                _sharedData->file = std::ofstream(_sharedData->path / MakeFileName(_sharedData->path));
+                _sharedData->Open();
             }
         }
         else if (_sharedData->opt.splitType == FileSplitType::Daily)
@@ -76,12 +672,14 @@ public:
 
             if (tm->tm_mday != _sharedData->lastMessageDay)
             {
+                details::AllowAllocations allow;
                 _sharedData->lastMessageDay = tm->tm_mday;
-                _sharedData->file.open(_sharedData->path / MakeFileName(_sharedData->path));
+                _sharedData->Open();
             }
         }
 
-        _sharedData->file << ss.str();
+        _sharedData->Write(record, line, _bloom);
+        _sharedData->Commit(record.Level);
     }
 
     [[nodiscard]] bool IsEnabled(LogLevel level) const noexcept override
@@ -89,10 +687,17 @@ public:
         return level >= _sharedData->opt.minLevel;
     }
 
+    [[nodiscard]] std::size_t MemoryUsage() const noexcept override
+    {
+        return sizeof(*this) + _name.capacity() + _formatter.MemoryUsage();
+    }
+
 private:
 
     std::string _name;                                        /**< Logger name */
     std::shared_ptr<FileProvider::SharedData> _sharedData;    /**< Shared data for all loggers created by common provider */
+    PatternFormatter _formatter;                              /**< Line layout with the category pre-rendered */
+    std::array<std::uint64_t, 4> _bloom;                      /**< Index bloom filter bits of the category */
 };
 
 FileProvider::FileProvider(std::filesystem::path where, FileProviderOptions opt)
@@ -103,12 +708,78 @@ FileProvider::FileProvider(std::filesystem::path where, FileProviderOptions opt)
         throw std::invalid_argument("FileProvider: messagesCount must be provided when splitType == NumMessages");
     }
 
+    if (opt.shared && opt.index)
+    {
+        throw std::invalid_argument("FileProvider: index can't be written in shared mode");
+    }
+
+    if (opt.shared && opt.backend != FileBackend::Stream)
+    {
+        throw std::invalid_argument("FileProvider: shared mode requires the stream backend");
+    }
+
+    if (opt.compression != FileCompression::None)
+    {
+        if (opt.shared || opt.index || opt.backend != FileBackend::Stream)
+            throw std::invalid_argument("FileProvider: compression can't be combined with shared mode, index or io_uring");
+
+        if (opt.compressionFrameSize == 0 || opt.compressionFrameSize > MaxCompressionFrameSize)
+            throw std::invalid_argument("FileProvider: compressionFrameSize must be between 1 byte and 64 MiB");
+
+        opt.compression = details::AvailableCodec(opt.compression);
+    }
+
     _providerData = std::make_shared<SharedData>();
     _providerData->path = where.replace_filename("");
     _providerData->opt = opt;
     _providerData->messageCounter = 0;
 
-    _providerData->file.open(_providerData->path / MakeFileName(_providerData->path));
+    if (opt.shared)
+        _providerData->OpenShared();
+    else
+        _providerData->Open();
+}
+
+std::future<void> FileProvider::Flush()
+{
+    std::lock_guard lock(_providerData->mutex);
+    if (_providerData->closed.load(std::memory_order_relaxed))
+        return details::ReadyFuture();
+
+    _providerData->FinishBlock();
+    _providerData->FlushData();
+    if (_providerData->opt.shared)
+        _providerData->WritePending();
+    return details::ReadyFuture();
+}
+
+std::future<void> FileProvider::Shutdown(std::chrono::steady_clock::time_point)
+{
+    std::lock_guard lock(_providerData->mutex);
+    _providerData->FinishBlock();
+    _providerData->closed.store(true, std::memory_order_release);
+    _providerData->CloseShared();
+    _providerData->CloseUring();
+    _providerData->compressed.reset();
+    _providerData->CloseCommitter();
+    _providerData->file.close();
+    _providerData->index.close();
+    return details::ReadyFuture();
+}
+
+bool FileProvider::WaitDurable(std::chrono::steady_clock::time_point deadline)
+{
+    return _providerData->WaitDurable(deadline);
+}
+
+FileBackend FileProvider::Backend() const noexcept
+{
+    return _providerData->opt.backend;
+}
+
+FileCompression FileProvider::Compression() const noexcept
+{
+    return _providerData->opt.compression;
 }
 
 std::string_view FileProvider::GetName() const
@@ -127,4 +798,9 @@ std::shared_ptr<ILogger> FileProvider::GetLogger(const std::string& name)
     return l;
 }
 
+void FileProvider::ReleaseLogger(const std::string& name)
+{
+    _loggers.erase(name);
+}
+
 CXLOG_NAMESPACE_END
\ No newline at end of file
@@ -2,12 +2,15 @@
 #include "cxlog/ConsoleProvider.hpp"
 #include "cxlog/LoggerFactory.hpp"
 
+#include <atomic>
 #include <iostream>
 
 static std::aligned_storage_t<sizeof(std::unique_ptr<cxlog::ILoggerFactory>),
                               alignof(std::unique_ptr<cxlog::ILoggerFactory>)> gLogFactoryStorage;
 
-static int nUnits = 0;
+/* Constant initialized, so it is ready before any initializer runs; initializers may run on several threads when
+ * shared libraries are loaded concurrently */
+static std::atomic<int> nUnits {0};
 
 
 namespace cxlog {
@@ -25,6 +28,13 @@ namespace cxlog {
 
     GLogInitializer::~GLogInitializer() {
         if (--nUnits == 0) {
+            /* Give buffered and asynchronous providers a chance to write out pending messages */
+            auto& factory = reinterpret_cast<std::unique_ptr<ILoggerFactory>&>(gLogFactoryStorage);
+            if (factory) {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                factory->Shutdown(deadline).wait_until(deadline);
+            }
+
             reinterpret_cast<std::unique_ptr<ILoggerFactory>&>(gLogFactoryStorage).~unique_ptr();
         }
     }
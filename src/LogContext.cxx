@@ -0,0 +1,70 @@
+#include "cxlog/LogContext.hpp"
+
+#include <algorithm>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+/* Packed fields of all scopes active on the thread, innermost last */
+struct ContextStack
+{
+    char data[ScopedContext::Capacity];
+    std::size_t size {0};
+};
+
+static thread_local ContextStack tContext;
+
+
+namespace details
+{
+    std::string_view CurrentContext() noexcept
+    {
+        return {tContext.data, tContext.size};
+    }
+
+    bool FindContextField(std::string_view context, std::string_view key, std::string_view& value) noexcept
+    {
+        bool found = false;
+        ForEachContextField(context, [&](std::string_view k, std::string_view v) {
+            if (k == key)
+            {
+                value = v;
+                found = true;
+            }
+        });
+        return found;
+    }
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+ScopedContext::ScopedContext(std::initializer_list<ContextField> fields) noexcept
+    : _previousSize(tContext.size)
+{
+    auto& stack = tContext;
+
+    for (const auto& field : fields)
+    {
+        auto key = field.Key();
+        auto value = field.Value();
+
+        if (stack.size + key.size() + value.size() + 2 > Capacity)
+            continue;
+
+        char* out = stack.data + stack.size;
+        out = std::copy(key.begin(), key.end(), out);
+        *out++ = details::ContextKeySeparator;
+        out = std::copy(value.begin(), value.end(), out);
+        *out++ = details::ContextFieldSeparator;
+
+        stack.size = static_cast<std::size_t>(out - stack.data);
+    }
+}
+
+ScopedContext::~ScopedContext()
+{
+    tContext.size = _previousSize;
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,103 @@
+#include "cxlog/LogIndex.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+static_assert(std::is_trivially_copyable_v<LogIndexEntry> && sizeof(LogIndexEntry) == 72,
+              "LogIndexEntry is stored as is and must keep its layout");
+
+static std::int64_t ToMicros(std::chrono::system_clock::time_point time) noexcept
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+void LogIndexEntry::Add(LogLevel level, std::chrono::system_clock::time_point timestamp,
+                        const std::array<std::uint64_t, 4>& bloom, std::size_t length) noexcept
+{
+    /* Lines of several threads or processes reach the file slightly out of timestamp order */
+    auto micros = ToMicros(timestamp);
+    MinTime = Lines == 0 ? micros : std::min(MinTime, micros);
+    MaxTime = Lines == 0 ? micros : std::max(MaxTime, micros);
+
+    Levels |= 1u << static_cast<unsigned>(level);
+    for (std::size_t i = 0; i < Categories.size(); ++i)
+        Categories[i] |= bloom[i];
+
+    Length += length;
+    ++Lines;
+}
+
+std::array<std::uint64_t, 4> LogIndexEntry::CategoryBloom(std::string_view category) noexcept
+{
+    /* FNV-1a, split into three 8 bit probes */
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : category)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+
+    std::array<std::uint64_t, 4> bits {};
+    for (int probe = 0; probe < 3; ++probe)
+    {
+        auto bit = (hash >> (probe * 8)) & 0xff;
+        bits[bit / 64] |= 1ull << (bit % 64);
+    }
+    return bits;
+}
+
+bool LogIndexFilter::MayMatch(const LogIndexEntry& entry) const noexcept
+{
+    if (From && entry.MaxTime < ToMicros(*From))
+        return false;
+
+    if (To && entry.MinTime > ToMicros(*To))
+        return false;
+
+    if (MinLevel && (entry.Levels >> static_cast<unsigned>(*MinLevel)) == 0)
+        return false;
+
+    if (Category)
+    {
+        auto bloom = LogIndexEntry::CategoryBloom(*Category);
+        for (std::size_t i = 0; i < bloom.size(); ++i)
+            if ((entry.Categories[i] & bloom[i]) != bloom[i])
+                return false;
+    }
+
+    return true;
+}
+
+std::vector<LogIndexEntry> ReadLogIndex(const std::filesystem::path& index)
+{
+    std::ifstream file(index, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Unable to open log index " + index.string());
+
+    char magic[sizeof(LogIndexEntry::Magic)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, LogIndexEntry::Magic, sizeof(magic)) != 0)
+        throw std::runtime_error("Not a log index " + index.string());
+
+    std::vector<LogIndexEntry> entries;
+    LogIndexEntry entry;
+    while (file.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+        entries.push_back(entry);
+
+    return entries;
+}
+
+std::filesystem::path LogIndexPath(const std::filesystem::path& segment)
+{
+    auto path = segment;
+    path += ".idx";
+    return path;
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,101 @@
+#include "cxlog/LogRecord.hpp"
+#include "cxlog/LogContext.hpp"
+#include "cxlog/PatternFormatter.hpp"
+
+#include <functional>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+/* Render target shared by all records rendered on a thread. Generation changes whenever the content is replaced. */
+struct RenderBuffer
+{
+    std::string data;
+    std::uint64_t generation {0};
+
+    /* Sized up front, so that rendering does not reallocate on the steady-state path */
+    RenderBuffer() { data.reserve(4096); }
+};
+
+static thread_local RenderBuffer tRenderBuffer;
+
+
+LogRecord LogRecord::Make(LogLevel level, std::string_view category, std::string_view message, std::uint32_t categoryId)
+{
+    LogRecord record;
+    record.Level = level;
+    record.CategoryId = categoryId;
+    record.Category = category;
+    record.Timestamp = std::chrono::system_clock::now();
+    record.ThreadId = CurrentThreadId();
+    record.ProcessId = CurrentProcessId();
+    record.Message = message;
+    record.Context = details::CurrentContext();
+    return record;
+}
+
+LogRecord& LogRecord::Own()
+{
+    if (!Storage || Storage->data() != Message.data())
+    {
+        auto storage = std::make_shared<std::string>();
+        storage->reserve(Message.size() + Context.size());
+        storage->append(Message).append(Context);
+
+        Message = std::string_view(*storage).substr(0, Message.size());
+        Context = std::string_view(*storage).substr(Message.size());
+        Storage = std::move(storage);
+    }
+    return *this;
+}
+
+std::string_view LogRecord::Render(const PatternFormatter& formatter) const
+{
+    auto& buffer = tRenderBuffer;
+
+    if (_renderedBuffer == &buffer && _renderedGeneration == buffer.generation && _renderedLayout == formatter.Layout())
+        return buffer.data;
+
+    buffer.data.clear();
+    formatter.Format(buffer.data, *this);
+
+    _renderedBuffer = &buffer;
+    _renderedGeneration = ++buffer.generation;
+    _renderedLayout = formatter.Layout();
+    return buffer.data;
+}
+
+std::uint64_t LogRecord::CurrentThreadId() noexcept
+{
+    thread_local const std::uint64_t id = []() -> std::uint64_t {
+#if defined(__linux__)
+        return static_cast<std::uint64_t>(::syscall(SYS_gettid));
+#else
+        return std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+    }();
+    return id;
+}
+
+std::uint32_t LogRecord::CurrentProcessId() noexcept
+{
+#ifdef _WIN32
+    return static_cast<std::uint32_t>(_getpid());
+#else
+    return static_cast<std::uint32_t>(::getpid());
+#endif
+}
+
+CXLOG_NAMESPACE_END
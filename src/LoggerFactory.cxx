@@ -2,34 +2,54 @@
 
 #include "cxlog/ILogger.hpp"
 #include "cxlog/ILoggerProvider.hpp"
+#include "cxlog/MessageArena.hpp"
+#include "AsyncQueue.hpp"
+#include "ShardedQueue.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <utility>
 #include <cassert>
+#include <mutex>
+#include <stdexcept>
 
 
 using namespace cxlog;
 
 
+struct cxlog::ProviderRecord
+{
+    std::shared_ptr<Logger> Source;     /**< Keeps the category the record refers to alive while it is queued */
+    std::shared_ptr<ILogger> Target;
+    LogRecord Record;
+};
+
 struct LoggerInfo
 {
     std::shared_ptr<ILoggerProvider> Provider;
     std::shared_ptr<ILogger> Logger;
     const LoggerRule* Rule;
+    std::weak_ptr<IAsyncQueue<ProviderRecord>> Queue;    /**< Provider's own queue with DispatchMode::PerProvider */
 
-    LoggerInfo(std::shared_ptr<ILoggerProvider> Provider, std::shared_ptr<ILogger> logger, const LoggerRule* rule = nullptr)
+    LoggerInfo(std::shared_ptr<ILoggerProvider> Provider, std::shared_ptr<ILogger> logger, const LoggerRule* rule = nullptr,
+               std::weak_ptr<IAsyncQueue<ProviderRecord>> queue = {})
         : Provider(std::move(Provider))
         , Logger(std::move(logger))
         , Rule(rule)
+        , Queue(std::move(queue))
     {
     }
 
+    /**
+     * @param forced Record of an enabled call site, which is not subject to the rule's minimum level
+     */
     [[nodiscard]]
-    bool IsEnabled(LogLevel level, std::string_view CategoryName) const noexcept
+    bool IsEnabled(LogLevel level, std::string_view CategoryName, bool forced = false) const noexcept
     {
         if (Rule)
         {
-            if (Rule->MinLevel && level < Rule->MinLevel.value())
+            if (!forced && Rule->MinLevel && level < Rule->MinLevel.value())
                 return false;
 
             if (Rule->Filter && !Rule->Filter(Provider->GetName(), CategoryName, level))
@@ -39,32 +59,151 @@ struct LoggerInfo
     }
 };
 
-class cxlog::Logger : public ILogger
+/* Record logged from a call site switched on with SiteMode::Enabled */
+static bool IsForced(const LogRecord& record) noexcept
+{
+    return record.Site && record.Site->Mode
+        && record.Site->Mode->load(std::memory_order_relaxed) == SiteMode::Enabled;
+}
+
+struct cxlog::AsyncRecord
+{
+    std::shared_ptr<Logger> Target;
+    LogRecord Record;
+};
+
+class cxlog::Logger : public ILogger, public std::enable_shared_from_this<Logger>
 {
-    std::vector<LoggerInfo> _loggers;
+    using LoggerList = std::vector<LoggerInfo>;
+
+    /* Providers of the logger, replaced as a whole by AddLogger() while other threads may be iterating it. Readers
+     * use the list within a ReadScope; superseded lists are freed by Prune() once no scope is open. */
+    std::atomic<const LoggerList*> _loggers;
+    std::vector<std::unique_ptr<const LoggerList>> _versions;   /**< Published lists, the current one last */
+    mutable std::atomic<std::uint32_t> _readers {0};            /**< Open read scopes */
     std::string _category;
+    std::uint32_t _categoryId;
+    std::weak_ptr<IAsyncQueue<AsyncRecord>> _queue;
+    std::atomic<std::int64_t> _lastUsed {0};    /**< steady_clock milliseconds of the last record, for eviction */
+
+    /* Sequentially consistent against Prune(): either the reader sees the new list or Prune() sees the reader */
+    class ReadScope
+    {
+    public:
+        explicit ReadScope(const Logger& logger) noexcept : _readers(logger._readers)
+        {
+            _readers.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~ReadScope()
+        {
+            _readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        ReadScope(const ReadScope&) = delete;
+        ReadScope& operator=(const ReadScope&) = delete;
+
+    private:
+        std::atomic<std::uint32_t>& _readers;
+    };
+
+    /* Only valid within a ReadScope, or with the factory mutex held */
+    [[nodiscard]]
+    const LoggerList& Loggers() const noexcept
+    {
+        return *_loggers.load(std::memory_order_seq_cst);
+    }
 
 public:
-    Logger(std::vector<LoggerInfo> loggers, std::string CategoryName)
-        : _loggers(std::move(loggers))
-        , _category(std::move(CategoryName))
+    Logger(std::vector<LoggerInfo> loggers, std::string CategoryName, std::uint32_t categoryId,
+           std::weak_ptr<IAsyncQueue<AsyncRecord>> queue = {})
+        : _category(std::move(CategoryName))
+        , _categoryId(categoryId)
+        , _queue(std::move(queue))
+    {
+        _versions.push_back(std::make_unique<const LoggerList>(std::move(loggers)));
+        _loggers.store(_versions.back().get(), std::memory_order_seq_cst);
+    }
+
+    void Log(LogLevel level, std::string_view message) noexcept override
     {
+        ReadScope scope(*this);
+        if (Loggers().empty())
+            return;
+
+        Log(LogRecord::Make(level, _category, message, _categoryId));
     }
 
-    void Log(LogLevel level, const std::string& message) noexcept override
+    void Log(const CallSite& site, std::string_view message) noexcept override
     {
-        if (_loggers.empty())
+        ReadScope scope(*this);
+        if (Loggers().empty())
             return;
 
-        for (const auto& loggerInfo : _loggers)
+        auto record = LogRecord::Make(site.Level, _category, message, _categoryId);
+        record.Site = &site;
+        Log(record);
+    }
+
+    void Log(const LogRecord& record) noexcept override
+    {
+        details::ArenaScope scope;
+        ReadScope reading(*this);
+        Touch();
+
+        /* When dispatching asynchronously, only enqueue records some provider is interested in */
+        if (auto queue = _queue.lock())
+        {
+            if (!IsForced(record) && !IsEnabled(record.Level))
+                return;
+
+            try
+            {
+                /* Record is handed over to another thread, so it can't live in the thread local arena */
+                details::AllowAllocations allow;
+                AsyncRecord pending{shared_from_this(), record};
+                pending.Record.Own();
+                queue->Push(record.Level, std::move(pending));
+            }
+            catch (...)
+            {
+            }
+            return;
+        }
+
+        Dispatch(record);
+    }
+
+    /**
+     * @brief Forwards the record to all enabled provider loggers, either directly on the calling thread or through
+     * the provider's own queue
+     */
+    void Dispatch(const LogRecord& record) noexcept
+    {
+        std::optional<LogRecord> owned;
+        auto forced = IsForced(record);
+        ReadScope scope(*this);
+
+        for (const auto& loggerInfo : Loggers())
         {
             /* If provider is not enabled logger enabled for level/category combination, skip it */
-            if (!loggerInfo.IsEnabled(level, _category))
+            if (!loggerInfo.IsEnabled(record.Level, _category, forced))
                 continue;
 
             try
             {
-                loggerInfo.Logger->Log(level, message);
+                if (auto queue = loggerInfo.Queue.lock())
+                {
+                    /* Message is copied once and shared by all provider queues */
+                    details::AllowAllocations allow;
+                    if (!owned)
+                        owned.emplace(record).Own();
+
+                    queue->Push(record.Level, ProviderRecord{shared_from_this(), loggerInfo.Logger, *owned});
+                    continue;
+                }
+
+                loggerInfo.Logger->Log(record);
             }
             catch (...)
             {
@@ -75,7 +214,8 @@ public:
     [[nodiscard]]
     bool IsEnabled(LogLevel level) const noexcept override
     {
-        for (const auto& log : _loggers)
+        ReadScope scope(*this);
+        for (const auto& log : Loggers())
             if (log.IsEnabled(level, _category))
             {
                 return true;
@@ -84,9 +224,54 @@ public:
         return false;
     }
 
+    /**
+     * @brief Publishes a copy of the provider list with the logger appended; called with the factory mutex held
+     */
     void AddLogger(LoggerInfo logger)
     {
-        _loggers.emplace_back(std::move(logger));
+        auto next = std::make_unique<LoggerList>(Loggers());
+        next->push_back(std::move(logger));
+
+        _loggers.store(next.get(), std::memory_order_seq_cst);
+        _versions.push_back(std::move(next));
+        Prune();
+    }
+
+    /**
+     * @brief Frees superseded provider lists unless a reader may still be using them; called with the factory mutex
+     * held
+     */
+    void Prune() noexcept
+    {
+        if (_versions.size() > 1 && _readers.load(std::memory_order_seq_cst) == 0)
+            _versions.erase(_versions.begin(), _versions.end() - 1);
+    }
+
+    [[nodiscard]]
+    std::size_t MemoryUsage() const noexcept override
+    {
+        auto bytes = sizeof(*this) + _category.capacity() + _versions.capacity() * sizeof(_versions[0]);
+        for (const auto& version : _versions)
+            bytes += sizeof(LoggerList) + version->capacity() * sizeof(LoggerInfo);
+        for (const auto& logger : Loggers())
+            bytes += logger.Logger->MemoryUsage();
+        return bytes;
+    }
+
+    /* Written only when the millisecond changes, so that threads sharing the logger rarely contend on it. Steady
+     * time, as a step of the wall clock would make every logger look idle, or none of them. */
+    void Touch() noexcept
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+        if (_lastUsed.load(std::memory_order_relaxed) != millis)
+            _lastUsed.store(millis, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]]
+    std::chrono::steady_clock::time_point LastUsed() const noexcept
+    {
+        return std::chrono::steady_clock::time_point(std::chrono::milliseconds(_lastUsed.load(std::memory_order_relaxed)));
     }
 };
 
@@ -107,6 +292,179 @@ LoggerFactory::LoggerFactory(const std::vector<std::shared_ptr<ILoggerProvider>>
     {
         _options.Rules.emplace_back().MinLevel = _options.MinLevel;
     }
+
+    if (_options.Async)
+    {
+        if (_options.Async->Capacity == 0 || _options.Async->PriorityCapacity == 0)
+        {
+            throw std::invalid_argument("LoggerFactory: async queue capacity must be positive");
+        }
+
+        auto dispatch = [](AsyncRecord& record) {
+            record.Target->Dispatch(record.Record);
+        };
+
+        if (_options.Async->Mode == DispatchMode::Shared)
+        {
+            _queue = std::make_shared<AsyncQueue<AsyncRecord>>(*_options.Async, dispatch);
+        }
+        else if (_options.Async->Mode == DispatchMode::Sharded)
+        {
+            _queue = std::make_shared<ShardedQueue<AsyncRecord>>(*_options.Async, dispatch);
+        }
+    }
+}
+
+LoggerFactory::~LoggerFactory()
+{
+    /* Drains the queues; loggers still held by the user fall back to synchronous dispatch */
+    _queue.reset();
+    _providerQueues.clear();
+}
+
+std::weak_ptr<IAsyncQueue<ProviderRecord>> LoggerFactory::GetProviderQueue(const ILoggerProvider* provider)
+{
+    if (!_options.Async || _options.Async->Mode != DispatchMode::PerProvider)
+        return {};
+
+    auto& queue = _providerQueues[provider];
+    if (!queue)
+    {
+        queue = std::make_shared<AsyncQueue<ProviderRecord>>(*_options.Async, [](ProviderRecord& record) {
+            record.Target->Log(record.Record);
+        });
+    }
+
+    return queue;
+}
+
+/* Completes a single promise once all parts have finished, reporting the first failure */
+struct FlushJoin
+{
+    std::mutex Mutex;
+    int Remaining {1};
+    std::exception_ptr Error;
+    std::promise<void> Promise;
+
+    void Add()
+    {
+        std::lock_guard lock(Mutex);
+        ++Remaining;
+    }
+
+    void Done(std::exception_ptr error = nullptr)
+    {
+        std::lock_guard lock(Mutex);
+        if (error && !Error)
+            Error = error;
+
+        if (--Remaining == 0)
+        {
+            if (Error)
+                Promise.set_exception(Error);
+            else
+                Promise.set_value();
+        }
+    }
+};
+
+std::future<void> LoggerFactory::ForEachProvider(const std::function<std::future<void>(ILoggerProvider&)>& action)
+{
+    auto join = std::make_shared<FlushJoin>();
+    auto future = join->Promise.get_future();
+
+    auto run = [join, action](ILoggerProvider& provider) {
+        try
+        {
+            action(provider).get();
+            join->Done();
+        }
+        catch (...)
+        {
+            join->Done(std::current_exception());
+        }
+    };
+
+    /* Taken under the lock, as providers may be added meanwhile; actions run without it */
+    std::vector<std::pair<std::shared_ptr<ILoggerProvider>, std::shared_ptr<IAsyncQueue<ProviderRecord>>>> providers;
+    {
+        std::lock_guard lock(_mutex);
+        for (const auto& provider : _providers)
+        {
+            auto it = _providerQueues.find(provider.get());
+            providers.emplace_back(provider, it != _providerQueues.end() ? it->second : nullptr);
+        }
+    }
+
+    /* Providers are only touched from the thread delivering messages to them */
+    for (const auto& [provider, queue] : providers)
+    {
+        join->Add();
+
+        if (_queue)
+            _queue->AddBarrier([run, provider = provider]{ run(*provider); });
+        else if (queue)
+            queue->AddBarrier([run, provider = provider]{ run(*provider); });
+        else
+            run(*provider);
+    }
+
+    join->Done();
+    return future;
+}
+
+std::future<void> LoggerFactory::Flush()
+{
+    return ForEachProvider([](ILoggerProvider& provider) { return provider.Flush(); });
+}
+
+std::future<void> LoggerFactory::Shutdown(std::chrono::steady_clock::time_point deadline)
+{
+    if (_queue)
+        _queue->DiscardAfter(deadline);
+    {
+        std::lock_guard lock(_mutex);
+        for (const auto& [provider, queue] : _providerQueues)
+            queue->DiscardAfter(deadline);
+    }
+
+    return ForEachProvider([deadline](ILoggerProvider& provider) { return provider.Shutdown(deadline); });
+}
+
+static void Accumulate(AsyncStats& total, const AsyncStats& stats) noexcept
+{
+    total.Enqueued += stats.Enqueued;
+    total.Dispatched += stats.Dispatched;
+    total.DroppedNewest += stats.DroppedNewest;
+    total.DroppedOldest += stats.DroppedOldest;
+    total.DroppedBelowLevel += stats.DroppedBelowLevel;
+    total.DroppedTimeout += stats.DroppedTimeout;
+    total.Discarded += stats.Discarded;
+}
+
+AsyncStats LoggerFactory::GetAsyncStats() const noexcept
+{
+    AsyncStats total = _queue ? _queue->Stats() : AsyncStats{};
+
+    std::lock_guard lock(_mutex);
+    for (const auto& [provider, queue] : _providerQueues)
+        Accumulate(total, queue->Stats());
+
+    return total;
+}
+
+AsyncStats LoggerFactory::GetAsyncStats(std::string_view providerName) const noexcept
+{
+    AsyncStats total;
+
+    std::lock_guard lock(_mutex);
+    for (const auto& [provider, queue] : _providerQueues)
+    {
+        if (provider->GetName() == providerName)
+            Accumulate(total, queue->Stats());
+    }
+
+    return total;
 }
 
 const LoggerRule *LoggerFactory::ApplyFilters(std::string_view Provider, std::string_view Category) const noexcept
@@ -131,32 +489,149 @@ const LoggerRule *LoggerFactory::ApplyFilters(std::string_view Provider, std::st
 
 std::shared_ptr<ILogger> LoggerFactory::CreateLogger(const std::string& category)
 {
-    auto& l = _loggers[category];
-    if (!l)
+    std::lock_guard lock(_mutex);
+
+    auto& entry = _loggers[category];
+    bool created = false;
+    if (!entry.Strong)
     {
-        l = std::make_shared<Logger>([&]()
+        /* Evicted logger which is still in use is cached again */
+        entry.Strong = entry.Weak.lock();
+        if (!entry.Strong)
         {
-            std::vector<LoggerInfo> loggers;
-            for (const auto& provider : _providers)
+            entry.Strong = std::make_shared<Logger>([&]()
             {
-                auto filters = ApplyFilters(provider->GetName(), category);
-                loggers.emplace_back(provider, provider->GetLogger(category), filters);
-            }
+                std::vector<LoggerInfo> loggers;
+                for (const auto& provider : _providers)
+                {
+                    auto filters = ApplyFilters(provider->GetName(), category);
+                    loggers.emplace_back(provider, provider->GetLogger(category), filters, GetProviderQueue(provider.get()));
+                }
+
+                return loggers;
+            }(), category, ++_nextCategoryId, _queue);
+            entry.Weak = entry.Strong;
+            created = true;
+        }
+        ++_cached;
+    }
+
+    auto logger = entry.Strong;
+    logger->Touch();
 
-            return loggers;
-        }(), category);
+    if (created && _options.MaxLoggers > 0 && _cached > _options.MaxLoggers)
+    {
+        Evict(std::max<std::size_t>(1, _options.MaxLoggers - _options.MaxLoggers / 8),
+              std::chrono::steady_clock::time_point::min());
     }
 
-    return l;
+    auto now = std::chrono::steady_clock::now();
+    if (_options.IdleTimeout.count() > 0 && now - _lastSweep >= _options.IdleTimeout)
+    {
+        _lastSweep = now;
+        Evict(_cached, now - _options.IdleTimeout);
+    }
+
+    return logger;
 }
 
 ILoggerFactory& LoggerFactory::AddProvider(std::shared_ptr<ILoggerProvider> provider)
 {
+    std::lock_guard lock(_mutex);
+
     _providers.push_back(provider);
-    for (auto& [category,logger] : _loggers)
+    auto queue = GetProviderQueue(provider.get());
+
+    for (auto& [category, entry] : _loggers)
     {
-        logger->AddLogger({provider, provider->GetLogger(category), ApplyFilters(provider->GetName(), category)});
+        /* Evicted loggers still in use get the provider as well, but it doesn't keep them */
+        auto logger = entry.Strong ? entry.Strong : entry.Weak.lock();
+        if (!logger)
+            continue;
+
+        logger->AddLogger({provider, provider->GetLogger(category), ApplyFilters(provider->GetName(), category), queue});
+        if (!entry.Strong)
+            provider->ReleaseLogger(category);
     }
 
     return *this;
-}
\ No newline at end of file
+}
+
+/*
+ * Evicts cached categories last used before idleSince, then the least recently used ones beyond keep. Entries of
+ * evicted loggers which are gone are dropped. Called with _mutex held.
+ */
+std::size_t LoggerFactory::Evict(std::size_t keep, std::chrono::steady_clock::time_point idleSince)
+{
+    std::vector<std::pair<std::chrono::steady_clock::time_point, decltype(_loggers)::iterator>> cached;
+    cached.reserve(_cached);
+
+    for (auto it = _loggers.begin(); it != _loggers.end();)
+    {
+        if (it->second.Strong)
+        {
+            it->second.Strong->Prune();
+            cached.emplace_back(it->second.Strong->LastUsed(), it);
+            ++it;
+        }
+        else if (it->second.Weak.expired())
+            it = _loggers.erase(it);
+        else
+            ++it;
+    }
+
+    /* Idle entries first, then oldest first */
+    auto idle = std::partition(cached.begin(), cached.end(), [&](const auto& entry) { return entry.first < idleSince; });
+    auto count = static_cast<std::size_t>(idle - cached.begin());
+    if (cached.size() - count > keep)
+    {
+        auto last = cached.end() - static_cast<std::ptrdiff_t>(keep);
+        std::nth_element(idle, last, cached.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        count = static_cast<std::size_t>(last - cached.begin());
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto it = cached[i].second;
+        for (const auto& provider : _providers)
+            provider->ReleaseLogger(it->first);
+
+        it->second.Weak = it->second.Strong;
+        it->second.Strong.reset();
+        if (it->second.Weak.expired())
+            _loggers.erase(it);
+    }
+
+    _cached -= count;
+    return count;
+}
+
+std::size_t LoggerFactory::EvictIdleLoggers()
+{
+    std::lock_guard lock(_mutex);
+
+    if (_options.IdleTimeout.count() <= 0)
+        return 0;
+
+    _lastSweep = std::chrono::steady_clock::now();
+    return Evict(_cached, _lastSweep - _options.IdleTimeout);
+}
+
+std::vector<CategoryMemory> LoggerFactory::GetMemoryUsage() const
+{
+    std::lock_guard lock(_mutex);
+
+    std::vector<CategoryMemory> usage;
+    for (const auto& [category, entry] : _loggers)
+    {
+        auto logger = entry.Strong ? entry.Strong : entry.Weak.lock();
+        if (!logger)
+            continue;
+
+        /* Map node and key of the factory's entry */
+        auto bytes = logger->MemoryUsage() + sizeof(*_loggers.begin()) + 4 * sizeof(void*) + category.capacity();
+        usage.push_back({category, bytes, entry.Strong != nullptr});
+    }
+
+    return usage;
+}
@@ -1,7 +1,7 @@
-#include <sstream>
 #include <utility>
 
 #include "cxlog/MemoryProvider.hpp"
+#include "cxlog/MessageArena.hpp"
 
 
 CXLOG_NAMESPACE_BEGIN
@@ -11,6 +11,7 @@ struct MemoryProvider::SharedInfo
 {
     LogLevel minLevel;
     int numLines;
+    std::string pattern;
 
     std::deque<std::string> logLines;
 };
@@ -19,25 +20,35 @@ class MemoryLogger : public ILogger
 {
     std::shared_ptr<MemoryProvider::SharedInfo> _info;
     const std::string _name;
+    PatternFormatter _formatter;
 public:
     MemoryLogger(std::shared_ptr<MemoryProvider::SharedInfo> data, std::string  name)
-        : _info(std::move(data)), _name(std::move(name))
+        : _info(std::move(data)), _name(std::move(name)), _formatter(_info->pattern, _name)
     {
     }
 
-    void Log(LogLevel level, const std::string& message) override
+    void Log(LogLevel level, std::string_view message) override
     {
-        if (!IsEnabled(level))
-            return;
+        Log(LogRecord::Make(level, _name, message));
+    }
 
-        std::stringstream ss;
-        ss << "[" << to_string(level) << "] " <<_name << ": " << message << "\n";
+    void Log(const LogRecord& record) override
+    {
+        if (!IsEnabled(record.Level))
+            return;
 
-        /* Remove the first line if we have too many */
+        /* Storing lines is what this provider is for; recycle the evicted line's storage for the new one */
+        details::AllowAllocations allow;
+        std::string line;
         if (_info->logLines.size() >= _info->numLines)
-            _info->logLines.erase(_info->logLines.begin());
-
-        _info->logLines.push_back(ss.str());
+        {
+            line = std::move(_info->logLines.front());
+            _info->logLines.pop_front();
+            line.clear();
+        }
+
+        line.append(record.Render(_formatter));
+        _info->logLines.push_back(std::move(line));
     }
 
     [[nodiscard]]
@@ -45,14 +56,21 @@ public:
     {
         return level >= _info->minLevel;
     }
+
+    [[nodiscard]]
+    std::size_t MemoryUsage() const noexcept override
+    {
+        return sizeof(*this) + _name.capacity() + _formatter.MemoryUsage();
+    }
 };
 
 
-MemoryProvider::MemoryProvider(int numLines, LogLevel minLevel)
+MemoryProvider::MemoryProvider(int numLines, LogLevel minLevel, std::string_view pattern)
     : _sharedInfo(std::make_shared<SharedInfo>())
 {
     _sharedInfo->minLevel = minLevel;
     _sharedInfo->numLines = numLines;
+    _sharedInfo->pattern = pattern;
 }
 
 std::vector<std::string> MemoryProvider::LogLines()
@@ -79,6 +97,11 @@ std::shared_ptr<ILogger> MemoryProvider::GetLogger(const std::string& name)
     return logger;
 }
 
+void MemoryProvider::ReleaseLogger(const std::string& name)
+{
+    _loggers.erase(name);
+}
+
 std::string_view MemoryProvider::GetName() const
 {
     return "MemoryProvider";
@@ -0,0 +1,109 @@
+#include "cxlog/MessageArena.hpp"
+
+#include <cstddef>
+#include <memory>
+
+#ifdef CXLOG_ALLOCATION_GUARD
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#endif
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+namespace details
+{
+    struct ThreadArena
+    {
+        static constexpr std::size_t InitialSize = 16 * 1024;
+
+        std::unique_ptr<std::byte[]> block {new std::byte[InitialSize]};
+        std::pmr::monotonic_buffer_resource resource {block.get(), InitialSize, std::pmr::new_delete_resource()};
+    };
+
+    static thread_local std::unique_ptr<ThreadArena> tArena;
+
+    /* Kept trivially destructible, as these are read from operator new, possibly during thread teardown */
+    static thread_local int tScopeDepth = 0;
+    static thread_local int tAllowDepth = 0;
+    static thread_local bool tWarmedUp = false;
+
+    std::pmr::memory_resource* MessageArena() noexcept
+    {
+        if (!tArena)
+        {
+            AllowAllocations allow;
+            tArena = std::make_unique<ThreadArena>();
+        }
+        return &tArena->resource;
+    }
+
+    ArenaScope::ArenaScope() noexcept
+    {
+        ++tScopeDepth;
+    }
+
+    ArenaScope::~ArenaScope()
+    {
+        if (--tScopeDepth == 0)
+        {
+            if (tArena)
+                tArena->resource.release();
+            tWarmedUp = true;
+        }
+    }
+
+    AllowAllocations::AllowAllocations() noexcept
+    {
+        ++tAllowDepth;
+    }
+
+    AllowAllocations::~AllowAllocations()
+    {
+        --tAllowDepth;
+    }
+}
+
+CXLOG_NAMESPACE_END
+
+
+#ifdef CXLOG_ALLOCATION_GUARD
+
+using namespace cxlog::details;
+
+static void CheckAllocation(std::size_t size) noexcept
+{
+    if (tScopeDepth > 0 && tWarmedUp && tAllowDepth == 0)
+    {
+        ++tAllowDepth;
+        std::fprintf(stderr, "cxlog: heap allocation of %zu bytes on the steady-state logging path\n", size);
+        std::abort();
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    CheckAllocation(size);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    CheckAllocation(size);
+
+    auto align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif /* CXLOG_ALLOCATION_GUARD */
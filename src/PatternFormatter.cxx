@@ -0,0 +1,254 @@
+#include "cxlog/PatternFormatter.hpp"
+#include "cxlog/CallSite.hpp"
+#include "cxlog/Escape.hpp"
+#include "cxlog/LogContext.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <set>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+/* Patterns are interned, so that equal layouts can be recognized by address. Entries are never released. */
+static const std::string* InternPattern(std::string_view pattern)
+{
+    static std::mutex mutex;
+    static std::set<std::string, std::less<>> patterns;
+
+    std::lock_guard lock(mutex);
+    auto it = patterns.find(pattern);
+    if (it == patterns.end())
+        it = patterns.emplace(pattern).first;
+
+    return &*it;
+}
+
+/* Broken down local time, cached per thread for the last rendered second */
+static const std::tm& LocalTime(std::time_t seconds) noexcept
+{
+    thread_local std::time_t cachedSeconds = -1;
+    thread_local std::tm cachedTm {};
+
+    if (seconds != cachedSeconds)
+    {
+#ifdef _WIN32
+        localtime_s(&cachedTm, &seconds);
+#else
+        localtime_r(&seconds, &cachedTm);
+#endif
+        cachedSeconds = seconds;
+    }
+    return cachedTm;
+}
+
+static void AppendPadded(std::string& out, unsigned value, int width)
+{
+    char digits[16];
+    auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+
+    for (auto n = end - digits; n < width; ++n)
+        out.push_back('0');
+    out.append(digits, end);
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+PatternFormatter::PatternFormatter(std::string_view pattern, std::string_view category)
+    : _pattern(InternPattern(pattern))
+{
+    for (std::size_t i = 0; i < pattern.size(); ++i)
+    {
+        if (pattern[i] != '%' || i + 1 == pattern.size())
+        {
+            AddLiteral(pattern.substr(i, 1));
+            continue;
+        }
+
+        switch (pattern[++i])
+        {
+            case 'Y': AddField(OpKind::Year); break;
+            case 'm': AddField(OpKind::Month); break;
+            case 'd': AddField(OpKind::Day); break;
+            case 'H': AddField(OpKind::Hour); break;
+            case 'M': AddField(OpKind::Minute); break;
+            case 'S': AddField(OpKind::Second); break;
+            case 'e': AddField(OpKind::Millis); break;
+            case 'f': AddField(OpKind::Micros); break;
+            case 'F':
+                AddField(OpKind::Year); AddLiteral("-");
+                AddField(OpKind::Month); AddLiteral("-");
+                AddField(OpKind::Day);
+                break;
+            case 'T':
+                AddField(OpKind::Hour); AddLiteral(":");
+                AddField(OpKind::Minute); AddLiteral(":");
+                AddField(OpKind::Second);
+                break;
+            case 'l': AddField(OpKind::Level); break;
+            case 't': AddField(OpKind::ThreadId); break;
+            case 'P': AddField(OpKind::ProcessId); break;
+            case 'v': AddField(OpKind::Message); break;
+            case 'J': AddField(OpKind::JsonMessage); break;
+            case 'V': AddField(OpKind::TextMessage); break;
+            case 'D': AddField(OpKind::Duration); break;
+            case 's': AddField(OpKind::SourceFile); break;
+            case '#': AddField(OpKind::SourceLine); break;
+            case '!': AddField(OpKind::Function); break;
+            case 'X':
+            {
+                auto close = pattern.find('}', i);
+                if (i + 1 < pattern.size() && pattern[i + 1] == '{' && close != std::string_view::npos)
+                {
+                    auto key = pattern.substr(i + 2, close - i - 2);
+                    _ops.push_back({OpKind::ContextField, static_cast<std::uint32_t>(_literals.size()), static_cast<std::uint32_t>(key.size())});
+                    _literals.append(key);
+                    i = close;
+                }
+                else
+                {
+                    AddField(OpKind::Context);
+                }
+                break;
+            }
+            case 'c': AddLiteral(category); break;
+            case 'n': AddLiteral("\n"); break;
+            case '%': AddLiteral("%"); break;
+            default: AddLiteral(pattern.substr(i - 1, 2)); break;
+        }
+    }
+}
+
+void PatternFormatter::AddLiteral(std::string_view text)
+{
+    if (text.empty())
+        return;
+
+    /* Merge adjacent constant pieces into a single append */
+    if (!_ops.empty() && _ops.back().kind == OpKind::Literal)
+    {
+        _ops.back().length += static_cast<std::uint32_t>(text.size());
+    }
+    else
+    {
+        _ops.push_back({OpKind::Literal, static_cast<std::uint32_t>(_literals.size()), static_cast<std::uint32_t>(text.size())});
+    }
+    _literals.append(text);
+}
+
+void PatternFormatter::AddField(OpKind kind)
+{
+    _ops.push_back({kind, 0, 0});
+    _needsTime |= kind >= OpKind::Year;
+}
+
+void PatternFormatter::Format(std::string& out, LogLevel level, std::string_view message) const
+{
+    Format(out, LogRecord::Make(level, {}, message));
+}
+
+void PatternFormatter::Format(std::string& out, const LogRecord& record) const
+{
+    const std::tm* tm = nullptr;
+    unsigned micros = 0;
+
+    if (_needsTime)
+    {
+        auto sinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(record.Timestamp.time_since_epoch());
+
+        tm = &LocalTime(static_cast<std::time_t>(sinceEpoch.count() / 1000000));
+        micros = static_cast<unsigned>(sinceEpoch.count() % 1000000);
+    }
+
+    for (const auto& op : _ops)
+    {
+        switch (op.kind)
+        {
+            case OpKind::Literal: out.append(_literals, op.offset, op.length); break;
+            case OpKind::Level: out.append(to_string(record.Level)); break;
+            case OpKind::Message: out.append(record.Message); break;
+            case OpKind::JsonMessage: AppendEscaped(out, record.Message, EscapeMode::Json); break;
+            case OpKind::TextMessage: AppendEscaped(out, record.Message, EscapeMode::Text); break;
+            case OpKind::ProcessId:
+            {
+                char digits[16];
+                auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), record.ProcessId);
+                out.append(digits, end);
+                break;
+            }
+            case OpKind::Duration:
+            {
+                if (!record.IsSpan())
+                    break;
+
+                char digits[24];
+                auto micros = std::chrono::duration_cast<std::chrono::microseconds>(record.SpanDuration).count();
+                auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), micros);
+                out.append(digits, end).append("us");
+                break;
+            }
+            case OpKind::Context:
+            {
+                bool first = true;
+                details::ForEachContextField(record.Context, [&](std::string_view key, std::string_view value) {
+                    if (!first)
+                        out.push_back(' ');
+                    out.append(key).append(1, '=').append(value);
+                    first = false;
+                });
+                break;
+            }
+            case OpKind::ContextField:
+            {
+                std::string_view value;
+                if (details::FindContextField(record.Context, std::string_view(_literals).substr(op.offset, op.length), value))
+                    out.append(value);
+                break;
+            }
+            case OpKind::SourceFile:
+            {
+                if (!record.Site)
+                    break;
+
+                std::string_view file = record.Site->File;
+                auto slash = file.find_last_of("/\\");
+                out.append(slash == std::string_view::npos ? file : file.substr(slash + 1));
+                break;
+            }
+            case OpKind::SourceLine:
+            {
+                if (!record.Site)
+                    break;
+
+                char digits[16];
+                auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), record.Site->Line);
+                out.append(digits, end);
+                break;
+            }
+            case OpKind::Function:
+                if (record.Site)
+                    out.append(record.Site->Function);
+                break;
+            case OpKind::ThreadId:
+            {
+                char digits[24];
+                auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), record.ThreadId);
+                out.append(digits, end);
+                break;
+            }
+            case OpKind::Year: AppendPadded(out, tm->tm_year + 1900, 4); break;
+            case OpKind::Month: AppendPadded(out, tm->tm_mon + 1, 2); break;
+            case OpKind::Day: AppendPadded(out, tm->tm_mday, 2); break;
+            case OpKind::Hour: AppendPadded(out, tm->tm_hour, 2); break;
+            case OpKind::Minute: AppendPadded(out, tm->tm_min, 2); break;
+            case OpKind::Second: AppendPadded(out, tm->tm_sec, 2); break;
+            case OpKind::Millis: AppendPadded(out, micros / 1000, 3); break;
+            case OpKind::Micros: AppendPadded(out, micros, 6); break;
+        }
+    }
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,454 @@
+#pragma once
+#include "AsyncQueue.hpp"
+#include "cxlog/MessageArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Queue with a single producer ring per thread and one consumer merging them in timestamp order
+ *
+ * @details Every producing thread claims a ring of its own on first use, so producers share no cache line that is
+ * written on the hot path: a push is a plain move into the slot and a release store of the ring's tail. The consumer
+ * repeatedly takes everything published in all rings and hands it over in (timestamp, ring) order using a k-way
+ * merge, so the output is ordered by time within each pass and per thread order is always kept. A record which has
+ * been time-stamped but not yet pushed when a pass starts may still follow later records of other threads.
+ *
+ * Rings are released when their thread exits, and reused by threads started later.
+ *
+ * Overflow is handled per ring: DropOldest behaves as DropNewest, as a producer can't evict from a ring it does not
+ * consume, and records at or above PriorityLevel always wait for room, as with the priority lane of AsyncQueue.
+ *
+ * @tparam T Queued item; must be default constructible, move assignable and have a LogRecord member Record.
+ */
+template<typename T>
+class ShardedQueue : public IAsyncQueue<T>
+{
+    static constexpr std::size_t CacheLine = 64;
+
+    struct Shard
+    {
+        explicit Shard(std::size_t capacity) : items(capacity), mask(capacity - 1) {}
+
+        std::vector<T> items;
+        const std::size_t mask;
+
+        alignas(CacheLine) std::atomic<std::uint64_t> tail {0};     /**< Written by the producer only */
+        std::atomic<std::uint64_t> enqueued {0};
+        std::atomic<std::uint64_t> droppedNewest {0};
+        std::atomic<std::uint64_t> droppedBelowLevel {0};
+        std::atomic<std::uint64_t> droppedTimeout {0};
+
+        alignas(CacheLine) std::atomic<std::uint64_t> head {0};     /**< Written by the consumer only */
+
+        alignas(CacheLine) std::atomic<bool> owned {false};         /**< Claimed by a live thread */
+    };
+
+    struct Barrier
+    {
+        std::vector<std::uint64_t> tails;   /**< Ring positions which must be consumed first */
+        std::function<void()> action;
+        std::promise<void> promise;
+    };
+
+    /* Oldest unconsumed item of a ring during a merge pass */
+    struct Head
+    {
+        std::int64_t timestamp;
+        std::size_t shard;
+
+        bool operator<(const Head& other) const noexcept
+        {
+            /* Inverted, as std heaps keep the largest element on top */
+            return timestamp != other.timestamp ? timestamp > other.timestamp : shard > other.shard;
+        }
+    };
+
+    /* Ring of the calling thread, released on thread exit */
+    struct LocalShard
+    {
+        std::uint64_t serial {0};
+        std::shared_ptr<Shard> shard;
+
+        ~LocalShard()
+        {
+            if (shard)
+                shard->owned.store(false, std::memory_order_release);
+        }
+    };
+
+public:
+    using Consumer = std::function<void(T&)>;
+
+    ShardedQueue(const AsyncOptions& options, Consumer consumer)
+        : _options(options)
+        , _consumer(std::move(consumer))
+        , _serial(NextSerial())
+    {
+        _capacity = 1;
+        while (_capacity < options.Capacity)
+            _capacity <<= 1;
+
+        _worker = std::thread([this]{ Run(); });
+    }
+
+    ~ShardedQueue() override
+    {
+        Stop();
+    }
+
+    ShardedQueue(const ShardedQueue&) = delete;
+    ShardedQueue& operator=(const ShardedQueue&) = delete;
+
+    bool Push(LogLevel level, T&& item) override
+    {
+        if (_stopped.load(std::memory_order_relaxed))
+            return false;
+
+        Shard& shard = LocalRing();
+        auto tail = shard.tail.load(std::memory_order_relaxed);
+
+        if (tail - shard.head.load(std::memory_order_acquire) > shard.mask && !WaitForRoom(shard, level, tail))
+            return false;
+
+        shard.items[tail & shard.mask] = std::move(item);
+        shard.tail.store(tail + 1, std::memory_order_release);
+        shard.enqueued.store(shard.enqueued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        /* Pairs with the fence in Run(), so that either the consumer sees the item or we see it sleeping */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_sleeping.load(std::memory_order_relaxed))
+            Wake();
+
+        return true;
+    }
+
+    std::future<void> AddBarrier(std::function<void()> action = {}) override
+    {
+        std::unique_lock lock(_mutex);
+
+        auto& barrier = _barriers.emplace_back();
+        for (const auto& shard : _shards)
+            barrier.tails.push_back(shard->tail.load(std::memory_order_acquire));
+        barrier.action = std::move(action);
+        auto future = barrier.promise.get_future();
+
+        /* Worker is gone, run the barrier right away */
+        if (_finished)
+        {
+            RunBarriers(lock, true);
+            return future;
+        }
+
+        _wake = true;
+        lock.unlock();
+        _wakeup.notify_one();
+        return future;
+    }
+
+    void DiscardAfter(std::chrono::steady_clock::time_point deadline) override
+    {
+        _discardAfter.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void Stop() override
+    {
+        {
+            std::lock_guard lock(_mutex);
+            if (_stopped.exchange(true))
+                return;
+        }
+
+        _wakeup.notify_all();
+        if (_worker.joinable())
+            _worker.join();
+    }
+
+    [[nodiscard]]
+    AsyncStats Stats() const noexcept override
+    {
+        AsyncStats stats;
+        stats.Dispatched = _dispatched.load(std::memory_order_relaxed);
+        stats.Discarded = _discarded.load(std::memory_order_relaxed);
+
+        std::lock_guard lock(_mutex);
+        for (const auto& shard : _shards)
+        {
+            stats.Enqueued += shard->enqueued.load(std::memory_order_relaxed);
+            stats.DroppedNewest += shard->droppedNewest.load(std::memory_order_relaxed);
+            stats.DroppedBelowLevel += shard->droppedBelowLevel.load(std::memory_order_relaxed);
+            stats.DroppedTimeout += shard->droppedTimeout.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+private:
+    static std::uint64_t NextSerial() noexcept
+    {
+        static std::atomic<std::uint64_t> serials {0};
+        return ++serials;
+    }
+
+    /* Finds the ring of the calling thread, claiming a free or new one on first use */
+    Shard& LocalRing()
+    {
+        thread_local LocalShard local;
+        if (local.serial == _serial)
+            return *local.shard;
+
+        details::AllowAllocations allow;
+        if (local.shard)
+            local.shard->owned.store(false, std::memory_order_release);
+
+        std::lock_guard lock(_mutex);
+        auto it = std::find_if(_shards.begin(), _shards.end(), [](const auto& s) {
+            bool expected = false;
+            return s->owned.compare_exchange_strong(expected, true, std::memory_order_acquire);
+        });
+
+        if (it == _shards.end())
+        {
+            auto shard = std::make_shared<Shard>(_capacity);
+            shard->owned.store(true, std::memory_order_relaxed);
+            it = _shards.insert(_shards.end(), std::move(shard));
+            _shardCount.store(_shards.size(), std::memory_order_release);
+        }
+
+        local.serial = _serial;
+        local.shard = *it;
+        return **it;
+    }
+
+    /* Applies the overflow policy to a full ring; true once there is room for the item */
+    bool WaitForRoom(Shard& shard, LogLevel level, std::uint64_t tail)
+    {
+        auto policy = level >= _options.PriorityLevel ? OverflowPolicy::Block : _options.Policy;
+        if (policy == OverflowPolicy::DropBelowLevel)
+        {
+            if (level < _options.DropLevel)
+            {
+                shard.droppedBelowLevel.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            policy = OverflowPolicy::Block;
+        }
+
+        if (policy != OverflowPolicy::Block)
+        {
+            shard.droppedNewest.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Wake();
+
+        auto deadline = std::chrono::steady_clock::now() + _options.BlockTimeout;
+        for (int spin = 0; tail - shard.head.load(std::memory_order_acquire) > shard.mask; ++spin)
+        {
+            if (_stopped.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() > deadline)
+            {
+                shard.droppedTimeout.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (spin < 64)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return true;
+    }
+
+    void Wake()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _wake = true;
+        }
+        _wakeup.notify_one();
+    }
+
+    [[nodiscard]]
+    bool BarrierReady() const noexcept
+    {
+        if (_barriers.empty())
+            return false;
+
+        const auto& tails = _barriers.front().tails;
+        for (std::size_t i = 0; i < tails.size(); ++i)
+        {
+            if (_shards[i]->head.load(std::memory_order_relaxed) < tails[i])
+                return false;
+        }
+        return true;
+    }
+
+    /* Runs barriers whose items are done, or all of them if forced. Called with the lock held. */
+    void RunBarriers(std::unique_lock<std::mutex>& lock, bool force)
+    {
+        while (force ? !_barriers.empty() : BarrierReady())
+        {
+            Barrier barrier = std::move(_barriers.front());
+            _barriers.pop_front();
+            lock.unlock();
+
+            try
+            {
+                if (barrier.action)
+                    barrier.action();
+                barrier.promise.set_value();
+            }
+            catch (...)
+            {
+                barrier.promise.set_exception(std::current_exception());
+            }
+
+            lock.lock();
+        }
+    }
+
+    /* Hands over everything published so far in timestamp order; returns the number of items taken */
+    std::size_t Drain(std::vector<std::shared_ptr<Shard>>& shards)
+    {
+        auto key = [](const T& item) { return item.Record.Timestamp.time_since_epoch().count(); };
+
+        _ends.resize(shards.size());
+        _heads.clear();
+        for (std::size_t i = 0; i < shards.size(); ++i)
+        {
+            auto& shard = *shards[i];
+            auto head = shard.head.load(std::memory_order_relaxed);
+            _ends[i] = shard.tail.load(std::memory_order_acquire);
+            if (head != _ends[i])
+                _heads.push_back(Head{key(shard.items[head & shard.mask]), i});
+        }
+        std::make_heap(_heads.begin(), _heads.end());
+
+        std::size_t taken = 0;
+        auto discardAfter = std::chrono::steady_clock::time_point(
+            std::chrono::steady_clock::duration(_discardAfter.load(std::memory_order_relaxed)));
+
+        while (!_heads.empty())
+        {
+            std::pop_heap(_heads.begin(), _heads.end());
+            auto index = _heads.back().shard;
+            _heads.pop_back();
+
+            auto& shard = *shards[index];
+            auto head = shard.head.load(std::memory_order_relaxed);
+            T item = std::move(shard.items[head & shard.mask]);
+            shard.items[head & shard.mask] = T{};
+            shard.head.store(head + 1, std::memory_order_release);
+            ++taken;
+
+            if (head + 1 != _ends[index])
+            {
+                _heads.push_back(Head{key(shard.items[(head + 1) & shard.mask]), index});
+                std::push_heap(_heads.begin(), _heads.end());
+            }
+
+            if (std::chrono::steady_clock::now() > discardAfter)
+            {
+                _discarded.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            try
+            {
+                _consumer(item);
+            }
+            catch (...)
+            {
+            }
+            _dispatched.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return taken;
+    }
+
+    void Run()
+    {
+        std::vector<std::shared_ptr<Shard>> shards;
+
+        for (;;)
+        {
+            if (shards.size() != _shardCount.load(std::memory_order_acquire))
+            {
+                std::lock_guard lock(_mutex);
+                shards = _shards;
+            }
+
+            if (Drain(shards) > 0)
+            {
+                std::unique_lock lock(_mutex);
+                RunBarriers(lock, false);
+                continue;
+            }
+
+            std::unique_lock lock(_mutex);
+            RunBarriers(lock, false);
+
+            if (_stopped.load(std::memory_order_relaxed))
+            {
+                /* Producers may still have been pushing while we drained */
+                lock.unlock();
+                if (shards.size() != _shardCount.load(std::memory_order_acquire) || Drain(shards) > 0)
+                    continue;
+
+                lock.lock();
+                RunBarriers(lock, true);
+                _finished = true;
+                return;
+            }
+
+            _sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            bool pending = shards.size() != _shardCount.load(std::memory_order_relaxed);
+            for (const auto& shard : shards)
+                pending = pending || shard->head.load(std::memory_order_relaxed) != shard->tail.load(std::memory_order_relaxed);
+
+            if (!pending)
+                _wakeup.wait(lock, [this]{ return _wake || _stopped.load(std::memory_order_relaxed); });
+
+            _wake = false;
+            _sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    const AsyncOptions _options;
+    const Consumer _consumer;
+    const std::uint64_t _serial;            /**< Unique id of the queue, keys the thread local ring cache */
+    std::size_t _capacity {1};              /**< Slots per ring */
+
+    mutable std::mutex _mutex;              /**< Guards the ring list, barriers and wake flag */
+    std::condition_variable _wakeup;
+    std::vector<std::shared_ptr<Shard>> _shards;
+    std::atomic<std::size_t> _shardCount {0};
+    std::deque<Barrier> _barriers;
+    bool _wake {false};
+    bool _finished {false};
+
+    alignas(CacheLine) std::atomic<bool> _sleeping {false};    /**< Read by every push, written rarely */
+    std::atomic<bool> _stopped {false};
+    std::atomic<std::chrono::steady_clock::rep> _discardAfter {std::chrono::steady_clock::time_point::max().time_since_epoch().count()};
+
+    alignas(CacheLine) std::atomic<std::uint64_t> _dispatched {0};
+    std::atomic<std::uint64_t> _discarded {0};
+    std::vector<std::uint64_t> _ends;       /**< Consumer scratch: ring positions of the current pass */
+    std::vector<Head> _heads;
+
+    std::thread _worker;
+};
+
+CXLOG_NAMESPACE_END
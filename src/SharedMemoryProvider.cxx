@@ -0,0 +1,288 @@
+#include "cxlog/SharedMemoryProvider.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+/*
+ * Ring layout: a 64 byte RingHeader followed by slotCount slots of slotSize bytes. Every slot starts with a
+ * SlotHeader followed by the line. Slot with sequence s is at index s & (slotCount - 1); its sequence word is
+ * 2s + 1 while being written and 2s + 2 once published, so a reader can tell an unwritten, a torn and an
+ * overwritten slot apart.
+ */
+static constexpr char RingMagic[8] = { 'C', 'X', 'L', 'S', 'H', 'M', '1', '\0' };
+
+struct RingHeader
+{
+    char magic[8];
+    std::uint32_t slotSize;
+    std::uint32_t slotCount;
+    std::atomic<std::uint64_t> head;    /**< Next sequence number to be claimed */
+    char padding[40];
+};
+
+struct SlotHeader
+{
+    std::atomic<std::uint64_t> sequence;
+    std::int64_t timestamp;             /**< Microseconds since epoch */
+    std::uint32_t length;
+    std::uint32_t level;
+    char padding[8];
+};
+
+static_assert(sizeof(RingHeader) == 64 && sizeof(SlotHeader) == 32, "Ring layout is shared between processes");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Ring atomics must be address free");
+
+static std::size_t RingSize(std::uint32_t slotSize, std::uint32_t slotCount)
+{
+    return sizeof(RingHeader) + static_cast<std::size_t>(slotSize) * slotCount;
+}
+
+static SlotHeader& SlotAt(std::byte* memory, const RingHeader& header, std::uint64_t sequence)
+{
+    auto index = sequence & (header.slotCount - 1);
+    return *reinterpret_cast<SlotHeader*>(memory + sizeof(RingHeader) + index * header.slotSize);
+}
+
+
+struct SharedMemoryProvider::SharedData
+{
+    std::string name;                 /**< Name of the shared memory object */
+    SharedMemoryProviderOptions opt;  /**< Provider options */
+    std::byte* memory {nullptr};      /**< Mapped ring */
+    std::size_t size {0};             /**< Size of the mapping */
+
+    RingHeader& header() const noexcept { return *reinterpret_cast<RingHeader*>(memory); }
+
+    ~SharedData()
+    {
+        if (memory)
+            ::munmap(memory, size);
+        if (opt.unlink)
+            ::shm_unlink(name.c_str());
+    }
+
+    void Publish(const LogRecord& record, std::string_view line) noexcept
+    {
+        auto& ring = header();
+        auto sequence = ring.head.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = SlotAt(memory, ring, sequence);
+
+        slot.sequence.store(2 * sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto length = std::min<std::size_t>(line.size(), opt.slotSize - sizeof(SlotHeader));
+        slot.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(record.Timestamp.time_since_epoch()).count();
+        slot.length = static_cast<std::uint32_t>(length);
+        slot.level = static_cast<std::uint32_t>(record.Level);
+        std::memcpy(reinterpret_cast<char*>(&slot + 1), line.data(), length);
+
+        slot.sequence.store(2 * sequence + 2, std::memory_order_release);
+    }
+};
+
+class SharedMemoryLogger : public ILogger
+{
+public:
+    SharedMemoryLogger(std::string name, std::shared_ptr<SharedMemoryProvider::SharedData> data)
+        : _name(std::move(name)), _sharedData(std::move(data)), _formatter(_sharedData->opt.pattern, _name)
+    {
+    }
+
+    void Log(LogLevel level, std::string_view message) override
+    {
+        Log(LogRecord::Make(level, _name, message));
+    }
+
+    void Log(const LogRecord& record) override
+    {
+        if (!IsEnabled(record.Level))
+            return;
+
+        _sharedData->Publish(record, record.Render(_formatter));
+    }
+
+    [[nodiscard]] bool IsEnabled(LogLevel level) const noexcept override
+    {
+        return level >= _sharedData->opt.minLevel;
+    }
+
+    [[nodiscard]] std::size_t MemoryUsage() const noexcept override
+    {
+        return sizeof(*this) + _name.capacity() + _formatter.MemoryUsage();
+    }
+
+private:
+    std::string _name;                                                /**< Logger name */
+    std::shared_ptr<SharedMemoryProvider::SharedData> _sharedData;    /**< Ring shared by all loggers of the provider */
+    PatternFormatter _formatter;                                      /**< Line layout with the category pre-rendered */
+};
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+SharedMemoryProvider::SharedMemoryProvider(const std::string& name, SharedMemoryProviderOptions opt)
+{
+    if (opt.slotCount == 0 || (opt.slotCount & (opt.slotCount - 1)) != 0)
+        throw std::invalid_argument("SharedMemoryProvider: slotCount must be a power of two");
+
+    if (opt.slotSize <= sizeof(SlotHeader) || opt.slotSize % 64 != 0)
+        throw std::invalid_argument("SharedMemoryProvider: slotSize must be a multiple of 64 larger than 32");
+
+    auto data = std::make_shared<SharedData>();
+    data->name = name;
+    data->opt = std::move(opt);
+    data->size = RingSize(data->opt.slotSize, data->opt.slotCount);
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "SharedMemoryProvider: shm_open " + name);
+
+    /* Truncating first discards the content of a ring left behind by a previous run */
+    if (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(data->size)) != 0)
+    {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "SharedMemoryProvider: ftruncate " + name);
+    }
+
+    void* memory = ::mmap(nullptr, data->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), "SharedMemoryProvider: mmap " + name);
+
+    data->memory = static_cast<std::byte*>(memory);
+
+    /* Magic is written last, so that readers never see a half initialized header */
+    auto& header = data->header();
+    header.slotSize = data->opt.slotSize;
+    header.slotCount = data->opt.slotCount;
+    header.head.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header.magic, RingMagic, sizeof(RingMagic));
+
+    _providerData = std::move(data);
+}
+
+SharedMemoryProvider::~SharedMemoryProvider() = default;
+
+std::shared_ptr<ILogger> SharedMemoryProvider::GetLogger(const std::string& name)
+{
+    auto& l = _loggers[name];
+    if (!l)
+    {
+        l = std::make_shared<SharedMemoryLogger>(name, _providerData);
+    }
+
+    return l;
+}
+
+void SharedMemoryProvider::ReleaseLogger(const std::string& name)
+{
+    _loggers.erase(name);
+}
+
+std::string_view SharedMemoryProvider::GetName() const
+{
+    return "SharedMemoryProvider";
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+SharedMemoryReader::SharedMemoryReader(const std::string& name, bool fromOldest)
+{
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "SharedMemoryReader: shm_open " + name);
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(RingHeader))
+    {
+        ::close(fd);
+        throw std::runtime_error("SharedMemoryReader: " + name + " is not a log ring");
+    }
+
+    _size = static_cast<std::size_t>(st.st_size);
+    void* memory = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+        throw std::system_error(errno, std::generic_category(), "SharedMemoryReader: mmap " + name);
+
+    _memory = static_cast<const std::byte*>(memory);
+
+    const auto& header = *reinterpret_cast<const RingHeader*>(_memory);
+    if (std::memcmp(header.magic, RingMagic, sizeof(RingMagic)) != 0
+        || header.slotCount == 0 || RingSize(header.slotSize, header.slotCount) > _size)
+    {
+        ::munmap(const_cast<std::byte*>(_memory), _size);
+        throw std::runtime_error("SharedMemoryReader: " + name + " is not a log ring");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    auto head = header.head.load(std::memory_order_acquire);
+    _next = !fromOldest ? head : head > header.slotCount ? head - header.slotCount : 0;
+}
+
+SharedMemoryReader::~SharedMemoryReader()
+{
+    ::munmap(const_cast<std::byte*>(_memory), _size);
+}
+
+SharedMemoryReader::Status SharedMemoryReader::Read(Record& record) noexcept
+{
+    auto& header = *reinterpret_cast<const RingHeader*>(_memory);
+    auto& slot = SlotAt(const_cast<std::byte*>(_memory), header, _next);
+
+    auto published = 2 * _next + 2;
+    auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+    if (sequence < published)
+    {
+        /* Not written yet, unless the writers are already a full ring ahead of us */
+        auto head = header.head.load(std::memory_order_relaxed);
+        if (head <= _next + header.slotCount)
+            return Status::Empty;
+    }
+
+    if (sequence != published)
+    {
+        /* Overwritten; continue with the oldest record which may still be intact */
+        auto head = header.head.load(std::memory_order_relaxed);
+        auto oldest = head > header.slotCount ? head - header.slotCount : 0;
+        oldest = std::max(oldest, _next + 1);
+
+        _lost += oldest - _next;
+        _next = oldest;
+        return Status::Lapped;
+    }
+
+    const auto* data = reinterpret_cast<const char*>(&slot + 1);
+    record.Sequence = _next;
+    record.Level = static_cast<LogLevel>(slot.level);
+    record.Timestamp = slot.timestamp;
+    record.Line = std::string_view(data, std::min<std::size_t>(slot.length, header.slotSize - sizeof(SlotHeader)));
+
+    ++_next;
+    return Status::Ok;
+}
+
+bool SharedMemoryReader::Valid(const Record& record) const noexcept
+{
+    auto& header = *reinterpret_cast<const RingHeader*>(_memory);
+    auto& slot = SlotAt(const_cast<std::byte*>(_memory), header, record.Sequence);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == 2 * record.Sequence + 2;
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,29 @@
+#include "cxlog/Span.hpp"
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+void Span::End() noexcept
+{
+    if (!_logger)
+        return;
+
+    auto end = std::chrono::steady_clock::now();
+
+    auto record = LogRecord::Make(_level, {}, _name);
+    record.SpanStart = _start;
+    record.SpanDuration = end - _start;
+
+    try
+    {
+        _logger->Log(record);
+    }
+    catch (...)
+    {
+    }
+
+    _logger = nullptr;
+}
+
+CXLOG_NAMESPACE_END
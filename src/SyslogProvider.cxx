@@ -25,10 +25,11 @@ static constexpr int LogLevelToSyslogLevel(LogLevel level)
 class SyslogLogger : public ILogger
 {
 public:
-    /* Forward message to syslog */
-    void Log(LogLevel level, const std::string& message) override
+    /* Forward message to syslog. Message view is not null terminated, pass its length explicitly */
+    void Log(LogLevel level, std::string_view message) override
     {
-        syslog(static_cast<int>(LogLevelToSyslogLevel(level)), "%s", message.c_str());
+        syslog(static_cast<int>(LogLevelToSyslogLevel(level)), "%.*s",
+               static_cast<int>(message.size()), message.data());
     }
 
     /* Log mask is controlled directly by syslog, always return true */
@@ -55,4 +56,9 @@ std::shared_ptr<ILogger> SyslogProvider::GetLogger(const std::string& name)
     return l;
 }
 
+void SyslogProvider::ReleaseLogger(const std::string& name)
+{
+    _loggers.erase(name);
+}
+
 std::string_view SyslogProvider::GetName() const { return "SyslogProvider"; }
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "cxlog/TraceEventProvider.hpp"
+#include "cxlog/Escape.hpp"
+#include "cxlog/MessageArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+/* Events serialized by one thread, waiting to be written out. Mutex is only contended while flushing. */
+struct ThreadBuffer
+{
+    std::thread::id owner;
+    std::mutex mutex;
+    std::string data;
+};
+
+struct TraceEventProvider::SharedData
+{
+    TraceEventProviderOptions opt;                      /**< Provider options */
+    std::uint64_t serial;                               /**< Unique id of the provider, keys the thread buffer cache */
+    std::chrono::system_clock::duration clockOffset;    /**< System clock minus monotonic clock */
+
+    std::mutex mutex;                                   /**< Guards everything below */
+    std::ofstream file;
+    bool empty {true};                                  /**< No event has been written yet */
+    std::atomic<bool> closed {false};                   /**< Set once the array has been terminated */
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; /**< Buffers of all threads which logged through the provider */
+
+    ~SharedData()
+    {
+        Close();
+    }
+
+    /* Finds or registers the buffer of the calling thread */
+    ThreadBuffer& LocalBuffer()
+    {
+        struct Cache
+        {
+            std::uint64_t serial {0};
+            std::shared_ptr<ThreadBuffer> buffer;
+        };
+        thread_local Cache cache;
+
+        if (cache.serial != serial)
+        {
+            details::AllowAllocations allow;
+            std::lock_guard lock(mutex);
+
+            auto id = std::this_thread::get_id();
+            auto it = std::find_if(buffers.begin(), buffers.end(), [&](const auto& b) { return b->owner == id; });
+            if (it == buffers.end())
+            {
+                auto buffer = std::make_shared<ThreadBuffer>();
+                buffer->owner = id;
+                buffer->data.reserve(opt.bufferSize + 256);
+                it = buffers.insert(buffers.end(), std::move(buffer));
+            }
+
+            cache.serial = serial;
+            cache.buffer = *it;
+        }
+        return *cache.buffer;
+    }
+
+    /* Appends events of a buffer to the file. Called with the mutex held. */
+    void WriteOut(ThreadBuffer& buffer)
+    {
+        std::lock_guard lock(buffer.mutex);
+        if (buffer.data.empty())
+            return;
+
+        /* Every event is prefixed with a separator, except for the very first one in the file */
+        std::string_view events = buffer.data;
+        if (empty)
+        {
+            events.remove_prefix(2);
+            empty = false;
+        }
+
+        if (!closed)
+            file.write(events.data(), static_cast<std::streamsize>(events.size()));
+        buffer.data.clear();
+    }
+
+    void Flush()
+    {
+        std::lock_guard lock(mutex);
+        for (auto& buffer : buffers)
+            WriteOut(*buffer);
+        file.flush();
+    }
+
+    void Close()
+    {
+        Flush();
+
+        std::lock_guard lock(mutex);
+        if (!closed)
+        {
+            file << "\n]\n";
+            file.close();
+            closed = true;
+        }
+    }
+};
+
+static void AppendJsonString(std::string& out, std::string_view text)
+{
+    out.push_back('"');
+    AppendEscaped(out, text, EscapeMode::Json);
+    out.push_back('"');
+}
+
+static void AppendNumber(std::string& out, std::uint64_t value)
+{
+    char digits[24];
+    auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+    out.append(digits, end);
+}
+
+/* Microseconds with nanosecond fraction, as expected by the trace viewers */
+static void AppendMicros(std::string& out, std::chrono::nanoseconds value)
+{
+    auto ns = static_cast<std::uint64_t>(value.count() > 0 ? value.count() : 0);
+    AppendNumber(out, ns / 1000);
+
+    char fraction[4] = { '.', static_cast<char>('0' + ns / 100 % 10), static_cast<char>('0' + ns / 10 % 10),
+                         static_cast<char>('0' + ns % 10) };
+    out.append(fraction, sizeof(fraction));
+}
+
+class TraceEventLogger : public ILogger
+{
+public:
+    TraceEventLogger(std::string name, std::shared_ptr<TraceEventProvider::SharedData> data)
+        : _name(std::move(name)), _sharedData(std::move(data))
+    {
+    }
+
+    void Log(LogLevel level, std::string_view message) override
+    {
+        Log(LogRecord::Make(level, _name, message));
+    }
+
+    void Log(const LogRecord& record) override
+    {
+        auto& data = *_sharedData;
+        if (!IsEnabled(record.Level) || (data.opt.spansOnly && !record.IsSpan()))
+            return;
+
+        auto& buffer = data.LocalBuffer();
+        {
+            std::lock_guard lock(buffer.mutex);
+            auto& out = buffer.data;
+
+            out.append(",\n{\"name\":");
+            AppendJsonString(out, record.Message);
+            out.append(",\"cat\":");
+            AppendJsonString(out, _name);
+
+            if (record.IsSpan())
+            {
+                out.append(",\"ph\":\"X\",\"ts\":");
+                AppendMicros(out, record.SpanStart.time_since_epoch());
+                out.append(",\"dur\":");
+                AppendMicros(out, record.SpanDuration);
+            }
+            else
+            {
+                out.append(",\"ph\":\"i\",\"s\":\"t\",\"ts\":");
+                AppendMicros(out, record.Timestamp.time_since_epoch() - data.clockOffset);
+            }
+
+            out.append(",\"pid\":");
+            AppendNumber(out, record.ProcessId);
+            out.append(",\"tid\":");
+            AppendNumber(out, record.ThreadId);
+            out.append(",\"args\":{\"level\":");
+            AppendJsonString(out, to_string(record.Level));
+            out.append("}}");
+
+            if (out.size() < data.opt.bufferSize)
+                return;
+        }
+
+        details::AllowAllocations allow;
+        std::lock_guard lock(data.mutex);
+        data.WriteOut(buffer);
+    }
+
+    [[nodiscard]]
+    bool IsEnabled(LogLevel level) const noexcept override
+    {
+        return level >= _sharedData->opt.minLevel && !_sharedData->closed;
+    }
+
+    [[nodiscard]]
+    std::size_t MemoryUsage() const noexcept override
+    {
+        return sizeof(*this) + _name.capacity();
+    }
+
+private:
+    std::string _name;
+    std::shared_ptr<TraceEventProvider::SharedData> _sharedData;
+};
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+TraceEventProvider::TraceEventProvider(const std::filesystem::path& file, TraceEventProviderOptions opt)
+    : _providerData(std::make_shared<SharedData>())
+{
+    static std::atomic<std::uint64_t> serials {0};
+
+    _providerData->opt = opt;
+    _providerData->serial = ++serials;
+    _providerData->clockOffset = std::chrono::system_clock::now().time_since_epoch()
+                               - std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                                     std::chrono::steady_clock::now().time_since_epoch());
+
+    _providerData->file.open(file, std::ios::out | std::ios::trunc);
+    if (!_providerData->file)
+        throw std::invalid_argument("Unable to open trace file " + file.string());
+
+    _providerData->file << "[\n";
+}
+
+std::shared_ptr<ILogger> TraceEventProvider::GetLogger(const std::string& name)
+{
+    auto& logger = _loggers[name];
+    if (!logger)
+        logger = std::make_shared<TraceEventLogger>(name, _providerData);
+
+    return logger;
+}
+
+void TraceEventProvider::ReleaseLogger(const std::string& name)
+{
+    _loggers.erase(name);
+}
+
+std::string_view TraceEventProvider::GetName() const
+{
+    return "TraceEventProvider";
+}
+
+std::future<void> TraceEventProvider::Flush()
+{
+    _providerData->Flush();
+    return details::ReadyFuture();
+}
+
+std::future<void> TraceEventProvider::Shutdown(std::chrono::steady_clock::time_point)
+{
+    _providerData->Close();
+    return details::ReadyFuture();
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,385 @@
+#include "UringFile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+CXLOG_NAMESPACE_BEGIN
+
+
+static constexpr std::uint64_t SyncTag = ~std::uint64_t(0);     /**< user_data of fdatasync requests */
+static constexpr unsigned SqPollIdleMillis = 100;               /**< Idle time before the kernel poller sleeps */
+
+static int Setup(unsigned entries, io_uring_params& params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+static int Enter(int fd, unsigned submit, unsigned wait, unsigned flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, submit, wait, flags, nullptr, 0));
+}
+
+static int Register(int fd, unsigned opcode, const void* arg, unsigned count)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+
+/* Mapped submission and completion rings */
+struct UringFile::Ring
+{
+    int fd {-1};
+    void* sq {MAP_FAILED};
+    void* cq {MAP_FAILED};
+    std::size_t sqSize {0};
+    std::size_t cqSize {0};
+    io_uring_sqe* sqes {static_cast<io_uring_sqe*>(MAP_FAILED)};
+    std::size_t sqesSize {0};
+
+    unsigned* sqHead {nullptr};
+    unsigned* sqTail {nullptr};
+    unsigned* sqFlags {nullptr};
+    unsigned sqMask {0};
+    unsigned sqEntries {0};
+    unsigned* sqArray {nullptr};
+
+    unsigned* cqHead {nullptr};
+    unsigned* cqTail {nullptr};
+    unsigned cqMask {0};
+    io_uring_cqe* cqes {nullptr};
+
+    unsigned tail {0};      /**< Tail including entries not published yet */
+    unsigned queued {0};    /**< Entries added since the last submission */
+    bool polled {false};    /**< Submission queue is consumed by a kernel thread (IORING_SETUP_SQPOLL) */
+
+    ~Ring()
+    {
+        if (sqes != MAP_FAILED)
+            ::munmap(sqes, sqesSize);
+        if (cq != MAP_FAILED && cq != sq)
+            ::munmap(cq, cqSize);
+        if (sq != MAP_FAILED)
+            ::munmap(sq, sqSize);
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    bool Map(unsigned entries, bool sqPoll)
+    {
+        /* A kernel thread polling the submission queue spares the writer the submitting syscall. It needs
+         * privileges before Linux 5.11, and registered files before IORING_FEAT_SQPOLL_NONFIXED. */
+        io_uring_params params {};
+        if (sqPoll)
+        {
+            params.flags = IORING_SETUP_SQPOLL;
+            params.sq_thread_idle = SqPollIdleMillis;
+            fd = Setup(entries, params);
+            if (fd >= 0 && !(params.features & IORING_FEAT_SQPOLL_NONFIXED))
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        polled = fd >= 0;
+        if (!polled)
+        {
+            params = io_uring_params{};
+            fd = Setup(entries, params);
+        }
+        if (fd < 0)
+            return false;
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single)
+            sqSize = cqSize = std::max(sqSize, cqSize);
+
+        sq = ::mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq == MAP_FAILED)
+            return false;
+
+        cq = single ? sq : ::mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED)
+            return false;
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                                 fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED)
+            return false;
+
+        auto* s = static_cast<char*>(sq);
+        sqHead = reinterpret_cast<unsigned*>(s + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(s + params.sq_off.tail);
+        sqFlags = reinterpret_cast<unsigned*>(s + params.sq_off.flags);
+        tail = *sqTail;
+        sqMask = *reinterpret_cast<unsigned*>(s + params.sq_off.ring_mask);
+        sqEntries = params.sq_entries;
+        sqArray = reinterpret_cast<unsigned*>(s + params.sq_off.array);
+
+        auto* c = static_cast<char*>(cq);
+        cqHead = reinterpret_cast<unsigned*>(c + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(c + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(c + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(c + params.cq_off.cqes);
+        return true;
+    }
+
+    /* The ring is sized for every buffer in flight along with its fsync, so a free entry always exists. Entries
+     * are published by SubmitQueued(), once they have been filled in. */
+    io_uring_sqe& Next() noexcept
+    {
+        auto index = tail++ & sqMask;
+        auto& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqArray[index] = index;
+        ++queued;
+        return sqe;
+    }
+
+    void SubmitQueued() noexcept
+    {
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+        if (polled)
+        {
+            /* The poller picks the entries up by itself, unless it has gone to sleep */
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if (__atomic_load_n(sqFlags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+                Enter(fd, 0, 0, IORING_ENTER_SQ_WAKEUP);
+            queued = 0;
+            return;
+        }
+
+        while (queued > 0)
+        {
+            int submitted = Enter(fd, queued, 0, 0);
+            if (submitted < 0 && errno == EINTR)
+                continue;
+            if (submitted <= 0)
+                break;
+            queued -= static_cast<unsigned>(submitted);
+        }
+    }
+};
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+UringFile::~UringFile()
+{
+    Close();
+}
+
+bool UringFile::Open(std::size_t bufferSize, unsigned bufferCount, bool sync, bool sqPoll)
+{
+    bufferCount = std::max(bufferCount, 2u);
+
+    unsigned entries = 1;
+    while (entries < 2 * bufferCount)
+        entries <<= 1;
+
+    auto ring = new Ring();
+    if (!ring->Map(entries, sqPoll))
+    {
+        delete ring;
+        return false;
+    }
+    _ring = ring;
+
+    void* memory = ::mmap(nullptr, bufferSize * bufferCount, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    _memory = static_cast<char*>(memory);
+    _bufferSize = bufferSize;
+    _sync = sync;
+
+    std::vector<iovec> iovecs;
+    for (unsigned i = 0; i < bufferCount; ++i)
+    {
+        _buffers.push_back({_memory + i * bufferSize, 0, 0});
+        _free.push_back(bufferCount - 1 - i);
+        iovecs.push_back({_memory + i * bufferSize, bufferSize});
+    }
+
+    /* Registration pins the buffers and fails beyond RLIMIT_MEMLOCK; plain writes work all the same */
+    _fixed = Register(_ring->fd, IORING_REGISTER_BUFFERS, iovecs.data(), bufferCount) == 0;
+    return true;
+}
+
+void UringFile::Close() noexcept
+{
+    if (_ring)
+    {
+        Flush();
+        delete _ring;
+        _ring = nullptr;
+    }
+
+    if (_memory)
+        ::munmap(_memory, _bufferSize * _buffers.size());
+    _memory = nullptr;
+}
+
+void UringFile::SetFile(int fd, std::uint64_t offset)
+{
+    Flush();
+    _fd = fd;
+    _offset = offset;
+}
+
+void UringFile::Write(std::string_view data)
+{
+    while (!data.empty())
+    {
+        if (_current == NoBuffer && !Acquire())
+        {
+            ++_errors;
+            return;
+        }
+
+        auto& buffer = _buffers[_current];
+        auto n = std::min(data.size(), _bufferSize - buffer.used);
+        std::memcpy(buffer.data + buffer.used, data.data(), n);
+        buffer.used += n;
+        data.remove_prefix(n);
+
+        if (buffer.used == _bufferSize)
+            Submit();
+    }
+}
+
+void UringFile::Submit()
+{
+    if (_current == NoBuffer || _buffers[_current].used == 0)
+        return;
+
+    auto index = _current;
+    auto& buffer = _buffers[index];
+    buffer.offset = _offset;
+    _offset += buffer.used;
+    _current = NoBuffer;
+
+    auto& write = _ring->Next();
+    write.opcode = _fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    write.fd = _fd;
+    write.off = buffer.offset;
+    write.addr = reinterpret_cast<std::uint64_t>(buffer.data);
+    write.len = static_cast<std::uint32_t>(buffer.used);
+    write.buf_index = static_cast<std::uint16_t>(_fixed ? index : 0);
+    write.user_data = index;
+    ++_pending;
+
+    if (_sync)
+    {
+        write.flags = IOSQE_IO_LINK;
+
+        auto& fsync = _ring->Next();
+        fsync.opcode = IORING_OP_FSYNC;
+        fsync.fd = _fd;
+        fsync.fsync_flags = IORING_FSYNC_DATASYNC;
+        fsync.user_data = SyncTag;
+        ++_pending;
+    }
+
+    _ring->SubmitQueued();
+}
+
+void UringFile::Flush()
+{
+    if (!_ring)
+        return;
+
+    Submit();
+    for (Reap(); _pending > 0 && Wait(); Reap())
+    {
+    }
+}
+
+/* Takes a free buffer, waiting for a write to complete if all of them are in flight */
+bool UringFile::Acquire()
+{
+    Reap();
+    while (_free.empty() && Wait())
+        Reap();
+
+    if (_free.empty())
+        return false;
+
+    _current = _free.back();
+    _free.pop_back();
+    _buffers[_current].used = 0;
+    return true;
+}
+
+void UringFile::Reap() noexcept
+{
+    auto head = *_ring->cqHead;
+    auto tail = __atomic_load_n(_ring->cqTail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head)
+    {
+        const auto& cqe = _ring->cqes[head & _ring->cqMask];
+        --_pending;
+
+        if (cqe.user_data == SyncTag)
+        {
+            /* A failed write cancels its linked fsync, which has been accounted for already */
+            if (cqe.res < 0 && cqe.res != -ECANCELED)
+                ++_errors;
+            continue;
+        }
+
+        auto index = static_cast<unsigned>(cqe.user_data);
+        auto& buffer = _buffers[index];
+        auto written = cqe.res < 0 ? 0 : static_cast<std::size_t>(cqe.res);
+
+        if (written < buffer.used)
+        {
+            /* Short or failed write; finish it the ordinary way */
+            ++_errors;
+            while (written < buffer.used)
+            {
+                auto n = ::pwrite(_fd, buffer.data + written, buffer.used - written,
+                                  static_cast<off_t>(buffer.offset + written));
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    break;
+                written += static_cast<std::size_t>(n);
+            }
+
+            /* The linked fsync has been cancelled along with the write */
+            if (_sync)
+                ::fdatasync(_fd);
+        }
+
+        _free.push_back(index);
+    }
+
+    __atomic_store_n(_ring->cqHead, head, __ATOMIC_RELEASE);
+}
+
+bool UringFile::Wait() noexcept
+{
+    int result;
+    while ((result = Enter(_ring->fd, 0, 1, IORING_ENTER_GETEVENTS)) < 0 && errno == EINTR)
+    {
+    }
+    return result >= 0;
+}
+
+CXLOG_NAMESPACE_END
@@ -0,0 +1,92 @@
+#pragma once
+#include "cxlog/defs.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+CXLOG_NAMESPACE_BEGIN
+
+/**
+ * @brief Appends to a file through io_uring, without liburing
+ *
+ * @details Data is copied into one of a fixed set of buffers, registered with the ring when the memlock limit
+ * allows. Full buffers are submitted as positioned writes, optionally linked with an fdatasync, and the writer moves
+ * on to the next free buffer right away; completions are reaped from the shared completion ring without a syscall.
+ * The writer only waits in the kernel when every buffer is in flight, or when asked to Flush().
+ *
+ * Writes carry explicit offsets, so they may complete in any order and the file still ends up in order.
+ *
+ * Every submission is an io_uring_enter() on the writer's thread, during which the kernel may already perform
+ * buffered writes. On request, and where the kernel allows it, the submission queue is consumed by a kernel thread
+ * instead (IORING_SETUP_SQPOLL), so submitting takes no syscall unless that thread has gone idle and needs a wakeup.
+ * That thread keeps polling for a while after every burst, costing CPU time.
+ */
+class UringFile
+{
+public:
+    UringFile() = default;
+    ~UringFile();
+
+    UringFile(const UringFile&) = delete;
+    UringFile& operator=(const UringFile&) = delete;
+
+    /**
+     * @brief Sets up the ring and its buffers
+     * @param sqPoll Try to have submissions picked up by a kernel polling thread
+     * @return false if io_uring is not available, in which case the object must not be used
+     */
+    bool Open(std::size_t bufferSize, unsigned bufferCount, bool sync, bool sqPoll = false);
+
+    /**
+     * @brief Directs further writes to fd, after everything written to the previous file has completed
+     * @param offset Offset in fd to start writing at
+     */
+    void SetFile(int fd, std::uint64_t offset);
+
+    /** @brief Copies data into the current buffer, submitting buffers as they fill up */
+    void Write(std::string_view data);
+
+    /** @brief Submits the partially filled buffer without waiting for it */
+    void Submit();
+
+    /** @brief Submits the partially filled buffer and waits until all writes have completed */
+    void Flush();
+
+    /** @return Number of writes which failed, or have been completed by a synchronous retry */
+    [[nodiscard]]
+    std::uint64_t Errors() const noexcept { return _errors; }
+
+private:
+    struct Buffer
+    {
+        char* data;
+        std::size_t used;
+        std::uint64_t offset;   /**< File offset the buffer is written at */
+    };
+
+    struct Ring;
+
+    void Close() noexcept;
+    bool Acquire();
+    void Reap() noexcept;
+    bool Wait() noexcept;
+
+    Ring* _ring {nullptr};
+    std::vector<Buffer> _buffers;
+    std::vector<unsigned> _free;            /**< Indexes of buffers not in flight */
+    unsigned _current {NoBuffer};           /**< Buffer being filled */
+    unsigned _pending {0};                  /**< Completions not reaped yet */
+    char* _memory {nullptr};
+    std::size_t _bufferSize {0};
+    bool _fixed {false};                    /**< Buffers have been registered */
+    bool _sync {false};                     /**< Link fdatasync to every write */
+    int _fd {-1};
+    std::uint64_t _offset {0};              /**< Offset of the next buffer submitted */
+    std::uint64_t _errors {0};
+
+    static constexpr unsigned NoBuffer = ~0u;
+};
+
+CXLOG_NAMESPACE_END
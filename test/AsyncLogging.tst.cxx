@@ -0,0 +1,399 @@
+#include "cxlog/LoggerFactory.hpp"
+#include "cxlog/MemoryProvider.hpp"
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace cxlog;
+
+/**
+ * Provider whose loggers block inside Log() until released, simulating a sink which can't keep up.
+ */
+class GateProvider : public ILoggerProvider
+{
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool open {false};
+        bool entered {false};
+        std::vector<std::string> messages;
+        std::vector<std::string> categories;
+    };
+
+    class GateLogger : public ILogger
+    {
+        std::shared_ptr<State> _state;
+    public:
+        explicit GateLogger(std::shared_ptr<State> state) : _state(std::move(state)) {}
+
+        void Log(LogLevel level, std::string_view message) override
+        {
+            Log(LogRecord::Make(level, {}, message));
+        }
+
+        void Log(const LogRecord& record) override
+        {
+            std::unique_lock lock(_state->mutex);
+            _state->entered = true;
+            _state->cv.notify_all();
+            _state->cv.wait(lock, [this]{ return _state->open; });
+            _state->messages.emplace_back(record.Message);
+            _state->categories.emplace_back(record.Category);
+        }
+
+        [[nodiscard]] bool IsEnabled(LogLevel) const noexcept override { return true; }
+    };
+
+    std::shared_ptr<State> _state = std::make_shared<State>();
+
+public:
+    [[nodiscard]] std::string_view GetName() const override { return "GateProvider"; }
+    std::shared_ptr<ILogger> GetLogger(const std::string&) override { return std::make_shared<GateLogger>(_state); }
+
+    /* Waits until the consumer thread is stuck inside the sink */
+    void WaitEntered()
+    {
+        std::unique_lock lock(_state->mutex);
+        _state->cv.wait(lock, [this]{ return _state->entered; });
+    }
+
+    void Open()
+    {
+        std::lock_guard lock(_state->mutex);
+        _state->open = true;
+        _state->cv.notify_all();
+    }
+
+    std::vector<std::string> Messages()
+    {
+        std::lock_guard lock(_state->mutex);
+        return _state->messages;
+    }
+
+    std::vector<std::string> Categories()
+    {
+        std::lock_guard lock(_state->mutex);
+        return _state->categories;
+    }
+};
+
+class AsyncLoggingTest : public ::testing::Test
+{
+protected:
+    static LoggerOptions Options(OverflowPolicy policy, std::size_t capacity)
+    {
+        LoggerOptions options;
+        options.Async = AsyncOptions{};
+        options.Async->Policy = policy;
+        options.Async->Capacity = capacity;
+        options.Async->BlockTimeout = std::chrono::milliseconds(10);
+        return options;
+    }
+};
+
+/**
+ * @brief Messages logged asynchronously are delivered once the factory is destroyed
+ */
+TEST_F(AsyncLoggingTest, DeliversOnDestruction)
+{
+    auto p = std::make_shared<MemoryProvider>(10);
+    {
+        LoggerFactory factory({ p }, Options(OverflowPolicy::Block, 16));
+        auto l = factory.CreateLogger("test");
+        l->Log(LogLevel::Info, "first");
+        l->Log(LogLevel::Info, "second");
+    }
+
+    EXPECT_EQ(p->LogLines().size(), 2);
+}
+
+TEST_F(AsyncLoggingTest, Construct_InvalidOptions)
+{
+    EXPECT_THROW(LoggerFactory({}, Options(OverflowPolicy::Block, 0)), std::invalid_argument);
+}
+
+TEST_F(AsyncLoggingTest, DropNewest)
+{
+    auto p = std::make_shared<GateProvider>();
+    AsyncStats stats;
+    {
+        LoggerFactory factory({ p }, Options(OverflowPolicy::DropNewest, 2));
+        auto l = factory.CreateLogger("test");
+
+        l->Log(LogLevel::Info, "0");
+        p->WaitEntered();
+        for (int i = 1; i <= 5; ++i)
+            l->Log(LogLevel::Info, std::to_string(i));
+
+        stats = factory.GetAsyncStats();
+        p->Open();
+    }
+
+    EXPECT_EQ(stats.DroppedNewest, 3);
+    EXPECT_EQ(p->Messages(), (std::vector<std::string>{"0", "1", "2"}));
+}
+
+TEST_F(AsyncLoggingTest, DropOldest)
+{
+    auto p = std::make_shared<GateProvider>();
+    AsyncStats stats;
+    {
+        LoggerFactory factory({ p }, Options(OverflowPolicy::DropOldest, 2));
+        auto l = factory.CreateLogger("test");
+
+        l->Log(LogLevel::Info, "0");
+        p->WaitEntered();
+        for (int i = 1; i <= 5; ++i)
+            l->Log(LogLevel::Info, std::to_string(i));
+
+        stats = factory.GetAsyncStats();
+        p->Open();
+    }
+
+    EXPECT_EQ(stats.DroppedOldest, 3);
+    EXPECT_EQ(p->Messages(), (std::vector<std::string>{"0", "4", "5"}));
+}
+
+TEST_F(AsyncLoggingTest, DropBelowLevel)
+{
+    auto p = std::make_shared<GateProvider>();
+    AsyncStats stats;
+    {
+        auto options = Options(OverflowPolicy::DropBelowLevel, 1);
+        options.Async->DropLevel = LogLevel::Warning;
+
+        LoggerFactory factory({ p }, options);
+        auto l = factory.CreateLogger("test");
+
+        l->Log(LogLevel::Info, "0");
+        p->WaitEntered();
+        l->Log(LogLevel::Info, "1");
+        l->Log(LogLevel::Debug, "2");
+        l->Log(LogLevel::Warning, "3");
+
+        stats = factory.GetAsyncStats();
+        p->Open();
+    }
+
+    EXPECT_EQ(stats.DroppedBelowLevel, 1);
+    EXPECT_EQ(stats.DroppedTimeout, 1);
+    EXPECT_EQ(p->Messages(), (std::vector<std::string>{"0", "1"}));
+}
+
+/**
+ * @brief Error records overtake queued records of lower severity
+ */
+TEST_F(AsyncLoggingTest, PriorityLane)
+{
+    auto p = std::make_shared<GateProvider>();
+    {
+        LoggerFactory factory({ p }, Options(OverflowPolicy::DropNewest, 4));
+        auto l = factory.CreateLogger("test");
+
+        l->Log(LogLevel::Debug, "0");
+        p->WaitEntered();
+        for (int i = 1; i <= 8; ++i)
+            l->Log(LogLevel::Debug, std::to_string(i));
+        l->Log(LogLevel::Error, "error");
+
+        p->Open();
+    }
+
+    auto messages = p->Messages();
+    ASSERT_EQ(messages.size(), 6);
+    EXPECT_EQ(messages[1], "error");
+}
+
+/**
+ * @brief With per-provider queues, a stalled sink neither delays nor drops records of other providers
+ */
+TEST_F(AsyncLoggingTest, PerProvider)
+{
+    auto gate = std::make_shared<GateProvider>();
+    auto memory = std::make_shared<MemoryProvider>(10);
+
+    AsyncStats gateStats, memoryStats;
+    {
+        auto options = Options(OverflowPolicy::DropNewest, 2);
+        options.Async->Mode = DispatchMode::PerProvider;
+
+        LoggerFactory factory({ gate, memory }, options);
+        auto l = factory.CreateLogger("test");
+
+        l->Log(LogLevel::Info, "0");
+        gate->WaitEntered();
+
+        /* Memory provider keeps up while the gate is still closed */
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        for (std::uint64_t i = 1; i <= 4; ++i)
+        {
+            l->Log(LogLevel::Info, std::to_string(i));
+            while (factory.GetAsyncStats("MemoryProvider").Dispatched < i + 1 && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+        }
+
+        gateStats = factory.GetAsyncStats("GateProvider");
+        memoryStats = factory.GetAsyncStats("MemoryProvider");
+        gate->Open();
+    }
+
+    EXPECT_EQ(memoryStats.Dispatched, 5);
+    EXPECT_EQ(memoryStats.DroppedNewest, 0);
+    EXPECT_EQ(gateStats.Dispatched, 0);
+    EXPECT_EQ(gateStats.DroppedNewest, 2);
+
+    EXPECT_EQ(memory->LogLines().size(), 5);
+    EXPECT_EQ(gate->Messages(), (std::vector<std::string>{"0", "1", "2"}));
+}
+
+/**
+ * @brief Flush returns once everything logged before has been delivered and providers have been flushed
+ */
+/**
+ * Records queued for a provider keep their category alive when the factory evicts its logger
+ */
+TEST_F(AsyncLoggingTest, PerProvider_Eviction)
+{
+    auto gate = std::make_shared<GateProvider>();
+    auto options = Options(OverflowPolicy::Block, 16);
+    options.Async->Mode = DispatchMode::PerProvider;
+    options.MaxLoggers = 1;
+    LoggerFactory factory({ gate }, options);
+
+    factory.CreateLogger("first")->Log(LogLevel::Info, "stuck");
+    gate->WaitEntered();
+
+    factory.CreateLogger("evicted")->Log(LogLevel::Info, "queued");
+    factory.CreateLogger("other");
+
+    gate->Open();
+    factory.Flush().get();
+
+    EXPECT_EQ(gate->Messages(), (std::vector<std::string>{ "stuck", "queued" }));
+    EXPECT_EQ(gate->Categories(), (std::vector<std::string>{ "first", "evicted" }));
+}
+
+TEST_F(AsyncLoggingTest, Flush)
+{
+    for (auto mode : { DispatchMode::Shared, DispatchMode::PerProvider, DispatchMode::Sharded })
+    {
+        auto p = std::make_shared<MemoryProvider>(1000);
+        auto options = Options(OverflowPolicy::Block, 16);
+        options.Async->Mode = mode;
+
+        LoggerFactory factory({ p }, options);
+        auto l = factory.CreateLogger("test");
+        for (int i = 0; i < 100; ++i)
+            l->Log(LogLevel::Info, "message");
+
+        factory.Flush().get();
+
+        EXPECT_EQ(p->LogLines().size(), 100);
+    }
+}
+
+/**
+ * @brief Records the consumer gets to after the shutdown deadline are discarded
+ */
+TEST_F(AsyncLoggingTest, Shutdown_Deadline)
+{
+    for (auto mode : { DispatchMode::Shared, DispatchMode::Sharded })
+    {
+        auto p = std::make_shared<GateProvider>();
+        auto options = Options(OverflowPolicy::Block, 16);
+        options.Async->Mode = mode;
+
+        LoggerFactory factory({ p }, options);
+        auto l = factory.CreateLogger("test");
+
+        l->Log(LogLevel::Info, "0");
+        p->WaitEntered();
+        l->Log(LogLevel::Info, "1");
+        l->Log(LogLevel::Info, "2");
+
+        auto done = factory.Shutdown(std::chrono::steady_clock::now());
+        p->Open();
+        done.get();
+
+        EXPECT_EQ(p->Messages(), std::vector<std::string>{"0"});
+        EXPECT_EQ(factory.GetAsyncStats().Discarded, 2);
+        EXPECT_EQ(factory.GetAsyncStats().DroppedTimeout, 0);
+    }
+}
+
+/**
+ * @brief Sharded queues deliver records of all threads, keeping the order of each thread
+ */
+TEST_F(AsyncLoggingTest, Sharded)
+{
+    static constexpr int numThreads = 4;
+    static constexpr int numMessages = 2000;
+
+    auto p = std::make_shared<MemoryProvider>(numThreads * numMessages, LogLevel::Trace, "%v");
+    AsyncStats stats;
+    {
+        auto options = Options(OverflowPolicy::Block, 64);
+        options.Async->Mode = DispatchMode::Sharded;
+        options.Async->BlockTimeout = std::chrono::seconds(10);
+
+        LoggerFactory factory({ p }, options);
+        auto l = factory.CreateLogger("test");
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < numMessages; ++i)
+                    l->Log(LogLevel::Info, std::to_string(t) + " " + std::to_string(i));
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        factory.Flush().get();
+        stats = factory.GetAsyncStats();
+    }
+
+    EXPECT_EQ(stats.Enqueued, numThreads * numMessages);
+    EXPECT_EQ(stats.Dispatched, numThreads * numMessages);
+
+    std::vector<int> next(numThreads, 0);
+    auto lines = p->LogLines();
+    ASSERT_EQ(lines.size(), numThreads * numMessages);
+    for (const auto& line : lines)
+    {
+        int thread = std::stoi(line);
+        EXPECT_EQ(std::stoi(line.substr(line.find(' ') + 1)), next[thread]++);
+    }
+}
+
+/**
+ * @brief A full ring sheds load like the normal lane does
+ */
+TEST_F(AsyncLoggingTest, Sharded_DropNewest)
+{
+    auto p = std::make_shared<GateProvider>();
+    AsyncStats stats;
+    {
+        auto options = Options(OverflowPolicy::DropNewest, 2);
+        options.Async->Mode = DispatchMode::Sharded;
+
+        LoggerFactory factory({ p }, options);
+        auto l = factory.CreateLogger("test");
+
+        l->Log(LogLevel::Info, "0");
+        p->WaitEntered();
+        for (int i = 1; i <= 5; ++i)
+            l->Log(LogLevel::Info, std::to_string(i));
+
+        stats = factory.GetAsyncStats();
+        p->Open();
+    }
+
+    EXPECT_EQ(stats.DroppedNewest, 3);
+    EXPECT_EQ(p->Messages(), (std::vector<std::string>{"0", "1", "2"}));
+}
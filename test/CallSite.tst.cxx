@@ -0,0 +1,144 @@
+#include "cxlog/CallSite.hpp"
+#include "cxlog/GLog.hpp"
+#include "cxlog/LoggerFactory.hpp"
+#include "cxlog/MemoryProvider.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace cxlog;
+
+static constexpr std::uint32_t NeverCalledLine = __LINE__ + 3;
+[[maybe_unused]] static void NeverCalled()
+{
+    CXLOG_WARNING("sites", "value {} of {}", 1, "x");
+}
+
+static const CallSite* FindSite(std::string_view format)
+{
+    auto sites = RegisteredCallSites();
+    auto it = std::find_if(sites.begin(), sites.end(), [&](const CallSite* site) { return site->Format == format; });
+    return it == sites.end() ? nullptr : *it;
+}
+
+/**
+ * @brief Statements are registered before main(), even if never executed
+ */
+TEST(CallSite, Registered)
+{
+    auto site = FindSite("value {} of {}");
+    ASSERT_NE(site, nullptr);
+
+    EXPECT_NE(std::strstr(site->File, "CallSite.tst.cxx"), nullptr);
+    EXPECT_EQ(site->Line, NeverCalledLine);
+    EXPECT_STREQ(site->Function, "NeverCalled");
+    EXPECT_EQ(site->Level, LogLevel::Warning);
+
+    ASSERT_EQ(site->ArgCount, 2u);
+    EXPECT_EQ(site->ArgTypes[0], ArgType::Int);
+    EXPECT_EQ(site->ArgTypes[1], ArgType::String);
+    EXPECT_EQ(site->ArgTypes[2], ArgType::None);
+    EXPECT_EQ(site->ArgOffsets[0], 6u);
+    EXPECT_EQ(site->ArgOffsets[1], 12u);
+}
+
+/**
+ * @brief Records logged through a site refer to it, and the site's placeholders are used for formatting
+ */
+TEST(CallSite, LogAt)
+{
+    auto provider = std::make_shared<MemoryProvider>(10, LogLevel::Trace, "%s:%# %! [%l] %v");
+    LoggerFactory factory({provider});
+    auto logger = factory.CreateLogger("main");
+
+    static constexpr details::SiteSource source { LogLevel::Info, __FILE__, __LINE__, "Fn", "{} apples, {} pears{}" };
+    details::LogAtSite<&source>(*logger, source.Format, 3, [] { return 4; });
+    details::LogAtSite<&source>(*logger, source.Format, 5);
+    logger->Log(LogLevel::Info, "plain");
+
+    auto line = std::to_string(source.Line);
+    EXPECT_EQ(provider->LogLines(), (std::vector<std::string> {
+        "CallSite.tst.cxx:" + line + " Fn [Info] 3 apples, 4 pears{}",
+        "CallSite.tst.cxx:" + line + " Fn [Info] 5 apples, {} pears{}",
+        ":  [Info] plain",
+    }));
+
+    /* One site per argument types; a statement written once always has the same ones */
+    auto sites = RegisteredCallSites();
+    EXPECT_EQ(std::count_if(sites.begin(), sites.end(), [&](const CallSite* site) { return site->Line == source.Line; }), 2);
+}
+
+static constexpr details::SiteSource SwitchDebug { LogLevel::Debug, "net/Switch.cxx", 10, "Poll", "polled {}" };
+static constexpr details::SiteSource SwitchOther { LogLevel::Debug, "net/Switch.cxx", 20, "Poll", "idle" };
+static constexpr details::SiteSource SwitchInfo { LogLevel::Info, "net/MySwitch.cxx", 10, "Accept", "quiet accept" };
+
+static void LogSwitchSites(ILogger& logger)
+{
+    details::LogAtSite<&SwitchDebug>(logger, SwitchDebug.Format, 1);
+    details::LogAtSite<&SwitchOther>(logger, SwitchOther.Format);
+    details::LogAtSite<&SwitchInfo>(logger, SwitchInfo.Format);
+}
+
+/**
+ * @brief Single statements can be enabled past the rules' minimum level, or silenced
+ */
+TEST(CallSite, SetCallSiteMode)
+{
+    auto provider = std::make_shared<MemoryProvider>(10);
+    LoggerFactory factory({provider}, LoggerOptions { .MinLevel = LogLevel::Info });
+    auto logger = factory.CreateLogger("net");
+
+    LogSwitchSites(*logger);
+    EXPECT_EQ(provider->LogLines(), std::vector<std::string> { "[Info] net: quiet accept\n" });
+
+    EXPECT_EQ(SetCallSiteMode("Switch.cxx:10", SiteMode::Enabled), 1u);
+    EXPECT_EQ(SetCallSiteMode("\"quiet\"", SiteMode::Disabled), 1u);
+    LogSwitchSites(*logger);
+    EXPECT_EQ(provider->LogLines(), std::vector<std::string> { "[Debug] net: polled 1\n" });
+
+    EXPECT_EQ(SetCallSiteMode("net/Switch.cxx", SiteMode::Default), 2u);
+    EXPECT_EQ(SetCallSiteMode("Poll()", SiteMode::Enabled), 2u);
+    EXPECT_EQ(SetCallSiteMode("witch.cxx", SiteMode::Enabled), 0u);
+    LogSwitchSites(*logger);
+    EXPECT_EQ(provider->LogLines(), (std::vector<std::string> { "[Debug] net: polled 1\n", "[Debug] net: idle\n" }));
+
+    EXPECT_THROW(SetCallSiteMode("Switch.cxx:0", SiteMode::Enabled), std::invalid_argument);
+    EXPECT_THROW(SetCallSiteMode(" ", SiteMode::Enabled), std::invalid_argument);
+
+    SetCallSiteMode("Poll()", SiteMode::Default);
+    SetCallSiteMode("Accept()", SiteMode::Default);
+}
+
+/**
+ * @brief Control file replaces all switches; a malformed one changes nothing
+ */
+TEST(CallSite, ApplyCallSiteControl)
+{
+    auto provider = std::make_shared<MemoryProvider>(10);
+    LoggerFactory factory({provider}, LoggerOptions { .MinLevel = LogLevel::Info });
+    auto logger = factory.CreateLogger("net");
+
+    auto path = (std::filesystem::temp_directory_path() / "cxlog-sites.ctl").string();
+    auto write = [&](std::string_view content) { std::ofstream(path, std::ios::trunc) << content; };
+
+    write("# switches\n+ Switch.cxx:20\n\n  -MySwitch.cxx\n");
+    EXPECT_EQ(ApplyCallSiteControl(path), 2u);
+    LogSwitchSites(*logger);
+    EXPECT_EQ(provider->LogLines(), std::vector<std::string> { "[Debug] net: idle\n" });
+
+    write("+Poll()\n*Accept()\n");
+    EXPECT_THROW(ApplyCallSiteControl(path), std::invalid_argument);
+    LogSwitchSites(*logger);
+    EXPECT_EQ(provider->LogLines(), std::vector<std::string> { "[Debug] net: idle\n" });
+
+    write("");
+    EXPECT_EQ(ApplyCallSiteControl(path), 0u);
+    LogSwitchSites(*logger);
+    EXPECT_EQ(provider->LogLines(), std::vector<std::string> { "[Info] net: quiet accept\n" });
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(ApplyCallSiteControl(path), std::runtime_error);
+}
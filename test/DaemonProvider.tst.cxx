@@ -0,0 +1,169 @@
+#include "cxlog/DaemonProtocol.hpp"
+#include "cxlog/DaemonProvider.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace cxlog;
+
+class DaemonProviderTest : public ::testing::Test
+{
+protected:
+    static constexpr const char* SOCKET = "/tmp/cxlog-DaemonProviderTest.sock";
+
+    void SetUp() override
+    {
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, SOCKET);
+
+        ::unlink(SOCKET);
+        _listener = ::socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        ASSERT_GE(_listener, 0);
+        ASSERT_EQ(0, ::bind(_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+        ASSERT_EQ(0, ::listen(_listener, 1));
+    }
+
+    void TearDown() override
+    {
+        if (_client >= 0)
+            ::close(_client);
+        ::close(_listener);
+        ::unlink(SOCKET);
+    }
+
+    static DaemonProviderOptions Options(const char* socketPath = SOCKET)
+    {
+        DaemonProviderOptions opt;
+        opt.socketPath = socketPath;
+        opt.flushInterval = std::chrono::hours(1);
+        return opt;
+    }
+
+    std::vector<daemon_protocol::Record> Receive()
+    {
+        if (_client < 0)
+            _client = ::accept(_listener, nullptr, nullptr);
+
+        _buffer.resize(64 * 1024);
+        auto received = ::recv(_client, _buffer.data(), _buffer.size(), 0);
+        _buffer.resize(received > 0 ? static_cast<std::size_t>(received) : 0);
+
+        std::vector<daemon_protocol::Record> records;
+        EXPECT_TRUE(daemon_protocol::ForEachRecord(_buffer, [&](const auto& r) { records.push_back(r); }));
+        return records;
+    }
+
+    int _listener {-1};
+    int _client {-1};
+    std::string _buffer;
+};
+
+TEST_F(DaemonProviderTest, Protocol_Roundtrip)
+{
+    using namespace daemon_protocol;
+
+    std::string batch;
+    BeginBatch(batch);
+
+    RecordHeader header {};
+    header.timestamp = 1234567;
+    header.threadId = 42;
+    header.level = static_cast<std::uint8_t>(LogLevel::Warning);
+    header.categoryLength = 3;
+    header.messageLength = 5;
+    AppendRecord(batch, header, "cat", "hello");
+    header.categoryLength = 0;
+    header.messageLength = 0;
+    AppendRecord(batch, header, "", "");
+
+    std::vector<Record> records;
+    ASSERT_TRUE(ForEachRecord(batch, [&](const Record& r) { records.push_back(r); }));
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ(1234567, records[0].Timestamp);
+    EXPECT_EQ(42u, records[0].ThreadId);
+    EXPECT_EQ(LogLevel::Warning, records[0].Level);
+    EXPECT_EQ("cat", records[0].Category);
+    EXPECT_EQ("hello", records[0].Message);
+    EXPECT_EQ("", records[1].Message);
+
+    /* Truncated batches and foreign data are rejected */
+    EXPECT_FALSE(ForEachRecord(std::string_view(batch).substr(0, batch.size() - 30), [](const Record&) {}));
+    EXPECT_FALSE(ForEachRecord("not a batch", [](const Record&) {}));
+}
+
+TEST_F(DaemonProviderTest, SendsBatchOnFlush)
+{
+    DaemonProvider provider(Options());
+    auto l = provider.GetLogger("daemon");
+
+    l->Log(LogLevel::Info, "first");
+    l->Log(LogLevel::Error, "second");
+    provider.Flush().wait();
+
+    auto records = Receive();
+    ASSERT_EQ(2u, records.size());
+    EXPECT_EQ("daemon", records[0].Category);
+    EXPECT_EQ("first", records[0].Message);
+    EXPECT_EQ(LogLevel::Error, records[1].Level);
+    EXPECT_EQ("second", records[1].Message);
+    EXPECT_EQ(0u, provider.Dropped());
+}
+
+TEST_F(DaemonProviderTest, SendsFullBatches)
+{
+    auto opt = Options();
+    opt.batchSize = 1024;
+    DaemonProvider provider(opt);
+    auto l = provider.GetLogger("daemon");
+
+    /* Each record takes 24 + 6 + 100 bytes, so 7 of them fill a batch */
+    std::string message(100, 'x');
+    for (int i = 0; i < 8; ++i)
+        l->Log(LogLevel::Info, message);
+
+    EXPECT_EQ(7u, Receive().size());
+    provider.Shutdown(std::chrono::steady_clock::now()).wait();
+    EXPECT_EQ(1u, Receive().size());
+
+    /* Records larger than a batch are truncated rather than lost */
+    DaemonProvider small(opt);
+    small.GetLogger("daemon")->Log(LogLevel::Info, std::string(4000, 'y'));
+    small.Flush().wait();
+    ::close(_client);
+    _client = -1;
+
+    auto records = Receive();
+    ASSERT_EQ(1u, records.size());
+    EXPECT_EQ(1024u - 8 - 24 - 6, records[0].Message.size());
+}
+
+TEST_F(DaemonProviderTest, DropsWithoutDaemon)
+{
+    DaemonProvider provider(Options("/tmp/cxlog-DaemonProviderTest-none.sock"));
+    auto l = provider.GetLogger("daemon");
+
+    l->Log(LogLevel::Info, "lost");
+    l->Log(LogLevel::Info, "lost");
+    provider.Flush().wait();
+
+    EXPECT_EQ(2u, provider.Dropped());
+}
+
+TEST_F(DaemonProviderTest, InvalidOptions)
+{
+    auto opt = Options();
+    opt.batchSize = 64;
+    EXPECT_THROW(DaemonProvider provider(opt), std::invalid_argument);
+
+    opt.batchSize = daemon_protocol::MaxBatchSize + 1;
+    EXPECT_THROW(DaemonProvider provider(opt), std::invalid_argument);
+
+    opt.batchSize = daemon_protocol::MaxBatchSize;
+    EXPECT_NO_THROW(DaemonProvider provider(opt));
+}
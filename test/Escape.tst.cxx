@@ -0,0 +1,104 @@
+#include "cxlog/Escape.hpp"
+#include "cxlog/PatternFormatter.hpp"
+
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace cxlog;
+
+/* Byte by byte reference of AppendEscaped() */
+static std::string Reference(std::string_view text, EscapeMode mode)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    std::string out;
+    for (char ch : text)
+    {
+        auto c = static_cast<unsigned char>(ch);
+        bool escape = mode == EscapeMode::Json ? c < 0x20 || c == '"' || c == '\\' : (c < 0x20 && c != '\t') || c == 0x7f;
+        if (!escape)
+            out.push_back(ch);
+        else if (c == '"') out += "\\\"";
+        else if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else if (c == '\r') out += "\\r";
+        else if (c == '\t') out += "\\t";
+        else
+        {
+            out += mode == EscapeMode::Json ? "\\u00" : "\\x";
+            out.push_back(hex[c >> 4]);
+            out.push_back(hex[c & 0xf]);
+        }
+    }
+    return out;
+}
+
+static std::string Escaped(std::string_view text, EscapeMode mode)
+{
+    std::string out;
+    AppendEscaped(out, text, mode);
+    return out;
+}
+
+TEST(Escape, Json)
+{
+    EXPECT_EQ(Escaped("", EscapeMode::Json), "");
+    EXPECT_EQ(Escaped("clean message", EscapeMode::Json), "clean message");
+    EXPECT_EQ(Escaped("say \"hi\"\n\tC:\\x", EscapeMode::Json), "say \\\"hi\\\"\\n\\tC:\\\\x");
+    EXPECT_EQ(Escaped(std::string_view("\x01\x1f\x7f\0", 4), EscapeMode::Json), "\\u0001\\u001f\x7f\\u0000");
+    EXPECT_EQ(Escaped("z\xc3\xa9", EscapeMode::Json), "z\xc3\xa9");
+}
+
+TEST(Escape, Text)
+{
+    EXPECT_EQ(Escaped("line 1\r\nline 2", EscapeMode::Text), "line 1\\r\\nline 2");
+    EXPECT_EQ(Escaped("tab\tquote\" C:\\x \x1b[31m\x7f", EscapeMode::Text), "tab\tquote\" C:\\x \\x1b[31m\\x7f");
+}
+
+/**
+ * @brief Vectorized scan finds the same bytes as the reference at every position, including the unaligned tail
+ */
+TEST(Escape, MatchesReference)
+{
+    std::mt19937 rng(42);
+    const char specials[] = { '"', '\\', '\n', '\t', '\x01', '\x1f', ' ', '\x7f', '\x80', '\xff' };
+
+    for (std::size_t size = 0; size < 80; ++size)
+    {
+        for (std::size_t at = 0; at <= size; ++at)
+        {
+            std::string text(size, 'a');
+            if (at < size)
+                text[at] = specials[rng() % sizeof(specials)];
+
+            for (auto mode : {EscapeMode::Json, EscapeMode::Text})
+            {
+                auto expected = Reference(text, mode);
+                ASSERT_EQ(Escaped(text, mode), expected) << "size " << size << " at " << at;
+
+                auto first = expected.size() == text.size() ? text.size() : at;
+                ASSERT_EQ(FindEscape(text, mode), first) << "size " << size << " at " << at;
+            }
+        }
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        std::string text(rng() % 300, '\0');
+        for (auto& c : text)
+            c = static_cast<char>(rng() % 8 == 0 ? specials[rng() % sizeof(specials)] : 'a' + rng() % 26);
+
+        EXPECT_EQ(Escaped(text, EscapeMode::Json), Reference(text, EscapeMode::Json));
+        EXPECT_EQ(Escaped(text, EscapeMode::Text), Reference(text, EscapeMode::Text));
+    }
+}
+
+TEST(Escape, PatternFields)
+{
+    PatternFormatter f("{\"msg\":\"%J\"} %V|%v");
+    std::string out;
+
+    f.Format(out, LogLevel::Info, "a\"b\nc");
+
+    EXPECT_EQ(out, "{\"msg\":\"a\\\"b\\nc\"} a\"b\\nc|a\"b\nc");
+}
@@ -1,7 +1,13 @@
 #include "gtest/gtest.h"
 #include "cxlog/FileProvider.hpp"
 
+#include <atomic>
 #include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace cxlog;
 
@@ -120,4 +126,369 @@ TEST_F(FileProviderTest, MaxLines)
 
     auto files = listFiles(PATH);
     EXPECT_EQ(files.size(), 2);
-}
\ No newline at end of file
+}
+
+TEST_F(FileProviderTest, FlushShutdown)
+{
+    FileProvider provider((std::filesystem::path(PATH)));
+    auto l = provider.GetLogger("MyLog");
+
+    l->Log(LogLevel::Info, MESSAGE);
+    provider.Flush().get();
+
+    auto files = listFiles(PATH);
+    ASSERT_EQ(files.size(), 1);
+    EXPECT_NE(dumpFile(files[0]).find(MESSAGE), std::string::npos);
+
+    provider.Shutdown(std::chrono::steady_clock::now()).get();
+    l->Log(LogLevel::Info, "AfterShutdown");
+
+    EXPECT_EQ(dumpFile(files[0]).find("AfterShutdown"), std::string::npos);
+}
+
+/**
+ * Shutdown while other threads are logging and flushing; every line written before it is whole
+ */
+TEST_F(FileProviderTest, FlushShutdown_Concurrent)
+{
+    FileProviderOptions opt = { .pattern = "%v%n", .index = true, .indexBlockSize = 256 };
+    FileProvider provider(std::filesystem::path(PATH), opt);
+    auto l = provider.GetLogger("MyLog");
+
+    std::atomic<bool> stop {false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed))
+                l->Log(LogLevel::Info, MESSAGE);
+        });
+    }
+    threads.emplace_back([&] {
+        while (!stop.load(std::memory_order_relaxed))
+            provider.Flush().get();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    provider.Shutdown(std::chrono::steady_clock::now()).get();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    stop = true;
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& file : listFiles(PATH))
+    {
+        if (file.extension() != ".log")
+            continue;
+
+        std::istringstream lines(dumpFile(file));
+        for (std::string line; std::getline(lines, line);)
+            ASSERT_EQ(line, MESSAGE);
+    }
+}
+/**
+ * Processes forked after the provider has been created append whole lines to the same file
+ */
+TEST_F(FileProviderTest, Shared_Fork)
+{
+    static constexpr int numMessages = 2000;
+    FileProvider provider(std::filesystem::path(PATH), { .pattern = "%c %v%n", .shared = true });
+
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+
+    auto l = provider.GetLogger(child == 0 ? "child" : "parent");
+    for (int i = 0; i < numMessages; ++i)
+        l->Log(LogLevel::Info, std::string(100, 'x'));
+
+    if (child == 0)
+        ::_exit(0);
+
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    ASSERT_EQ(status, 0);
+
+    std::istringstream lines(dumpFile(std::filesystem::path(PATH) / "current.log"));
+    int count = 0;
+    for (std::string line; std::getline(lines, line); ++count)
+    {
+        ASSERT_TRUE(line == "child " + std::string(100, 'x') || line == "parent " + std::string(100, 'x')) << line;
+    }
+    EXPECT_EQ(count, 2 * numMessages);
+}
+
+/**
+ * A process forked after the first group commit gets durable records committed by a thread of its own
+ */
+TEST_F(FileProviderTest, Shared_Fork_GroupCommit)
+{
+    FileProviderOptions opt = { .pattern = "%c %v%n", .shared = true, .durability = FileDurability::GroupCommit,
+                                .durableLevel = LogLevel::Warning };
+    FileProvider provider(std::filesystem::path(PATH), opt);
+    provider.GetLogger("parent")->Log(LogLevel::Critical, MESSAGE);
+    ASSERT_TRUE(provider.WaitDurable(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+
+    if (child == 0)
+    {
+        provider.GetLogger("child")->Log(LogLevel::Critical, MESSAGE);
+        ::_exit(provider.WaitDurable(std::chrono::steady_clock::now() + std::chrono::seconds(10)) ? 0 : 1);
+    }
+
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    EXPECT_EQ(status, 0);
+    EXPECT_NE(dumpFile(std::filesystem::path(PATH) / "current.log").find(std::string("child ") + MESSAGE),
+              std::string::npos);
+}
+
+/**
+ * Rotation is coordinated through the shared state, so files hold messagesCount lines no matter who wrote them
+ */
+TEST_F(FileProviderTest, Shared_Rotation)
+{
+    FileProviderOptions opt = { .splitType = FileSplitType::NumMessages, .messagesCount = 3, .pattern = "%v%n",
+                                .shared = true, .sharedBatchSize = 64 };
+    {
+        FileProvider first(std::filesystem::path(PATH), opt);
+        FileProvider second(std::filesystem::path(PATH), opt);
+        auto l1 = first.GetLogger("first");
+        auto l2 = second.GetLogger("second");
+
+        for (int i = 0; i < 4; ++i)
+        {
+            l1->Log(LogLevel::Info, MESSAGE);
+            l2->Log(LogLevel::Info, MESSAGE);
+        }
+    }
+
+    std::vector<std::size_t> sizes;
+    for (const auto& file : listFiles(PATH))
+    {
+        if (file.extension() == ".log")
+            sizes.push_back(dumpFile(file).size());
+    }
+
+    std::sort(sizes.begin(), sizes.end());
+    auto line = std::string(MESSAGE).size() + 1;
+    EXPECT_EQ(sizes, (std::vector<std::size_t> { 2 * line, 3 * line, 3 * line }));
+}
+
+TEST_F(FileProviderTest, Shared_InvalidOptions)
+{
+    EXPECT_THROW(FileProvider(std::filesystem::path(PATH), { .index = true, .shared = true }), std::invalid_argument);
+}
+
+/**
+ * io_uring backend keeps lines in order across buffers in flight and across file splits
+ */
+TEST_F(FileProviderTest, IoUring)
+{
+    static constexpr int numMessages = 5000;
+    FileProviderOptions opt = { .splitType = FileSplitType::NumMessages, .messagesCount = 2000, .pattern = "%v%n",
+                                .backend = FileBackend::IoUring, .uringBufferSize = 4096, .uringBufferCount = 3,
+                                .uringSync = true };
+    {
+        FileProvider provider(std::filesystem::path(PATH), opt);
+        if (provider.Backend() != FileBackend::IoUring)
+            GTEST_SKIP() << "io_uring is not available";
+
+        auto l = provider.GetLogger("MyLog");
+        for (int i = 0; i < numMessages; ++i)
+            l->Log(LogLevel::Info, std::to_string(i));
+    }
+
+    /* Files split within the same second are named out of order; order them by content instead */
+    std::vector<std::vector<int>> files;
+    for (const auto& file : listFiles(PATH))
+    {
+        std::istringstream lines(dumpFile(file));
+        auto& values = files.emplace_back();
+        for (std::string line; std::getline(lines, line);)
+            values.push_back(std::stoi(line));
+    }
+
+    std::sort(files.begin(), files.end());
+    ASSERT_EQ(files.size(), 3);
+
+    int expected = 0;
+    for (const auto& values : files)
+    {
+        for (auto value : values)
+            ASSERT_EQ(value, expected++);
+    }
+    EXPECT_EQ(expected, numMessages);
+}
+
+/**
+ * Submissions picked up by a kernel polling thread, where permitted, write the same file
+ */
+TEST_F(FileProviderTest, IoUring_SqPoll)
+{
+    static constexpr int numMessages = 5000;
+    FileProviderOptions opt = { .pattern = "%v%n", .backend = FileBackend::IoUring, .uringBufferSize = 4096,
+                                .uringBufferCount = 3, .uringSqPoll = true };
+    {
+        FileProvider provider(std::filesystem::path(PATH), opt);
+        if (provider.Backend() != FileBackend::IoUring)
+            GTEST_SKIP() << "io_uring is not available";
+
+        auto l = provider.GetLogger("MyLog");
+        for (int i = 0; i < numMessages; ++i)
+            l->Log(LogLevel::Info, std::to_string(i));
+    }
+
+    auto files = listFiles(PATH);
+    ASSERT_EQ(files.size(), 1);
+
+    std::istringstream lines(dumpFile(files[0]));
+    int expected = 0;
+    for (std::string line; std::getline(lines, line);)
+        ASSERT_EQ(std::stoi(line), expected++);
+    EXPECT_EQ(expected, numMessages);
+}
+
+/**
+ * Records at or above durableLevel reach the file right away with FileDurability::Flush
+ */
+TEST_F(FileProviderTest, Durability_Flush)
+{
+    FileProvider provider(std::filesystem::path(PATH), { .durability = FileDurability::Flush });
+    auto l = provider.GetLogger("MyLog");
+
+    l->Log(LogLevel::Error, MESSAGE);
+
+    auto files = listFiles(PATH);
+    ASSERT_EQ(files.size(), 1);
+    EXPECT_NE(dumpFile(files[0]).find(MESSAGE), std::string::npos);
+    EXPECT_TRUE(provider.WaitDurable());
+}
+
+/**
+ * WaitDurable covers records committed across a file split
+ */
+TEST_F(FileProviderTest, Durability_GroupCommit)
+{
+    FileProviderOptions opt = { .splitType = FileSplitType::NumMessages, .messagesCount = 2,
+                                .durability = FileDurability::GroupCommit, .durableLevel = LogLevel::Warning,
+                                .groupCommitWindow = std::chrono::milliseconds(5) };
+    FileProvider provider(std::filesystem::path(PATH), opt);
+    auto l = provider.GetLogger("MyLog");
+
+    for (int i = 0; i < 5; ++i)
+    {
+        l->Log(LogLevel::Info, "Info");
+        l->Log(LogLevel::Critical, MESSAGE);
+    }
+
+    EXPECT_TRUE(provider.WaitDurable(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+
+    auto files = listFiles(PATH);
+    ASSERT_GT(files.size(), 1);
+    for (const auto& file : files)
+        EXPECT_NE(dumpFile(file).find(MESSAGE), std::string::npos);
+}
+
+/**
+ * Every codec round-trips lines across frames and file splits; each frame holds whole lines and decodes on its own
+ */
+TEST_F(FileProviderTest, Compression)
+{
+    static constexpr int numMessages = 3000;
+
+    for (auto codec : {FileCompression::Lz, FileCompression::Zlib, FileCompression::Zstd})
+    {
+        FileProviderOptions opt = { .splitType = FileSplitType::NumMessages, .messagesCount = 2000, .pattern = "%l %v%n",
+                                    .compression = codec, .compressionFrameSize = 4096 };
+        FileCompression used;
+        {
+            FileProvider provider(std::filesystem::path(PATH), opt);
+            used = provider.Compression();
+            EXPECT_TRUE(used == codec || used == FileCompression::Lz);
+
+            auto l = provider.GetLogger("MyLog");
+            for (int i = 0; i < numMessages; ++i)
+                l->Log(LogLevel::Info, "request " + std::to_string(i) + " served in " + std::to_string(i % 17) + "ms");
+        }
+
+        std::vector<std::vector<int>> files;
+        for (const auto& file : listFiles(PATH))
+        {
+            ASSERT_EQ(file.extension(), ".cxz");
+
+            CompressedLogReader reader(file);
+            EXPECT_EQ(reader.Codec(), used);
+            EXPECT_TRUE(reader.Indexed());
+            ASSERT_GT(reader.Frames().size(), 1);
+
+            auto& values = files.emplace_back();
+            std::uint64_t rawOffset = 0;
+            std::uint64_t compressed = 0;
+            for (std::size_t frame = 0; frame < reader.Frames().size(); ++frame)
+            {
+                EXPECT_EQ(reader.Frames()[frame].rawOffset, rawOffset);
+                rawOffset += reader.Frames()[frame].rawSize;
+                compressed += reader.Frames()[frame].size;
+
+                auto text = reader.ReadFrame(frame);
+                ASSERT_EQ(text.back(), '\n');
+
+                std::istringstream lines(text);
+                for (std::string line; std::getline(lines, line);)
+                {
+                    ASSERT_EQ(line.rfind("Info request ", 0), 0) << line;
+                    values.push_back(std::stoi(line.substr(13)));
+                }
+            }
+            EXPECT_LT(compressed * 2, rawOffset);
+        }
+
+        std::sort(files.begin(), files.end());
+        ASSERT_EQ(files.size(), 2);
+
+        int expected = 0;
+        for (const auto& values : files)
+        {
+            for (auto value : values)
+                ASSERT_EQ(value, expected++);
+        }
+        EXPECT_EQ(expected, numMessages);
+
+        TearDown();
+    }
+}
+
+/**
+ * Files which have not been closed are read by walking their frames; Flush writes the partial frame
+ */
+TEST_F(FileProviderTest, Compression_Unclosed)
+{
+    FileProvider provider(std::filesystem::path(PATH), { .pattern = "%v%n", .compression = FileCompression::Lz });
+    auto l = provider.GetLogger("MyLog");
+
+    l->Log(LogLevel::Info, MESSAGE);
+    provider.Flush().get();
+    l->Log(LogLevel::Info, "Second");
+    provider.Flush().get();
+
+    auto files = listFiles(PATH);
+    ASSERT_EQ(files.size(), 1);
+
+    CompressedLogReader reader(files[0]);
+    EXPECT_FALSE(reader.Indexed());
+    ASSERT_EQ(reader.Frames().size(), 2);
+    EXPECT_EQ(reader.ReadFrame(1), "Second\n");
+    EXPECT_EQ(reader.ReadAll(), std::string(MESSAGE) + "\nSecond\n");
+}
+
+TEST_F(FileProviderTest, Compression_InvalidOptions)
+{
+    auto path = std::filesystem::path(PATH);
+    EXPECT_THROW(FileProvider(path, { .index = true, .compression = FileCompression::Lz }), std::invalid_argument);
+    EXPECT_THROW(FileProvider(path, { .shared = true, .compression = FileCompression::Lz }), std::invalid_argument);
+    EXPECT_THROW(FileProvider(path, { .compression = FileCompression::Lz, .compressionFrameSize = 0 }),
+                 std::invalid_argument);
+    EXPECT_THROW(CompressedLogReader(path / "missing.log.cxz"), std::runtime_error);
+}
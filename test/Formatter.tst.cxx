@@ -0,0 +1,155 @@
+#include "cxlog/Formatter.hpp"
+#include "cxlog/ILogger.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace cxlog;
+
+namespace
+{
+    struct Point
+    {
+        int x, y;
+    };
+
+    struct Streamed
+    {
+        int value;
+    };
+
+    std::ostream& operator<<(std::ostream& os, const Streamed& s)
+    {
+        return os << "streamed(" << s.value << ")";
+    }
+
+    enum class Color { Red, Green = 7 };
+    enum Plain { PlainA = 3 };
+    enum class Named { On };
+
+    std::ostream& operator<<(std::ostream& os, Named)
+    {
+        return os << "On";
+    }
+
+    enum Unscoped { UnscopedOff, UnscopedOn };
+
+    std::ostream& operator<<(std::ostream& os, const Unscoped& value)
+    {
+        return os << (value == UnscopedOn ? "on" : "off");
+    }
+}
+
+template<>
+struct cxlog::formatter<Point>
+{
+    static void Format(FormatBuffer& out, const Point& p)
+    {
+        out.push_back('(');
+        formatter<int>::Format(out, p.x);
+        out.push_back(',');
+        formatter<int>::Format(out, p.y);
+        out.push_back(')');
+    }
+};
+
+template<typename T>
+static std::string Formatted(const T& value)
+{
+    details::ArenaScope scope;
+    FormatBuffer buffer;
+    formatter<T>::Format(buffer, value);
+    return std::string(buffer.view());
+}
+
+template<typename T>
+static std::string StreamText(const T& value)
+{
+    std::ostringstream os;
+    os << value;
+    return os.str();
+}
+
+/**
+ * @brief Built-in formatters produce the same text as a default constructed stream
+ */
+TEST(Formatter, MatchesStream)
+{
+    for (auto value : {0, 1, -1, 42, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()})
+        EXPECT_EQ(Formatted(value), StreamText(value));
+
+    EXPECT_EQ(Formatted(std::numeric_limits<std::uint64_t>::max()), StreamText(std::numeric_limits<std::uint64_t>::max()));
+    EXPECT_EQ(Formatted(std::numeric_limits<std::int64_t>::min()), StreamText(std::numeric_limits<std::int64_t>::min()));
+    EXPECT_EQ(Formatted(short(-7)), StreamText(short(-7)));
+
+    for (auto value : {0.0, 0.1, -2.5, 3.14159265, 1e6, 123456.7, 1e-7, 1e300})
+        EXPECT_EQ(Formatted(value), StreamText(value));
+    EXPECT_EQ(Formatted(1.5f), StreamText(1.5f));
+
+    EXPECT_EQ(Formatted('x'), StreamText('x'));
+    EXPECT_EQ(Formatted(true), StreamText(true));
+    EXPECT_EQ(Formatted(PlainA), StreamText(PlainA));
+    EXPECT_EQ(Formatted(Named::On), "On");
+    EXPECT_EQ(Formatted(UnscopedOn), "on");
+    EXPECT_EQ(Formatted(UnscopedOn), StreamText(UnscopedOn));
+
+    /* Enums without an inserter of their own skip the stream */
+    static_assert(!details::is_custom_streamable_enum<Plain>::value && !details::is_custom_streamable_enum<Color>::value);
+    static_assert(details::is_custom_streamable_enum<Unscoped>::value && details::is_custom_streamable_enum<Named>::value);
+    EXPECT_EQ(Formatted(Streamed{5}), "streamed(5)");
+
+    int i = 0;
+    EXPECT_EQ(Formatted(&i), StreamText(static_cast<const void*>(&i)));
+}
+
+TEST(Formatter, Strings)
+{
+    const char* null = nullptr;
+    const char* text = "text";
+
+    EXPECT_EQ(Formatted(text), "text");
+    EXPECT_EQ(Formatted(null), "(null)");
+    EXPECT_EQ(Formatted(std::string("string")), "string");
+    EXPECT_EQ(Formatted(std::string_view("view")), "view");
+}
+
+TEST(Formatter, Specials)
+{
+    EXPECT_EQ(Formatted(Color::Green), "7");
+    EXPECT_EQ(Formatted(LogLevel::Warning), "Warning");
+    EXPECT_EQ(Formatted(nullptr), "nullptr");
+
+    EXPECT_EQ(Formatted(std::chrono::milliseconds(250)), "250ms");
+    EXPECT_EQ(Formatted(std::chrono::microseconds(-3)), "-3us");
+    EXPECT_EQ(Formatted(std::chrono::hours(2)), "2h");
+    EXPECT_EQ(Formatted(std::chrono::duration<double>(1.5)), "1.5s");
+    EXPECT_EQ(Formatted(std::chrono::duration<int, std::ratio<1, 30>>(4)), "4[1/30]s");
+    EXPECT_EQ(Formatted(std::chrono::duration<int, std::ratio<86400>>(1)), "1[86400]s");
+
+    EXPECT_EQ(Formatted(Point{1, -2}), "(1,-2)");
+}
+
+/**
+ * @brief Messages use the formatters of their arguments, including results of deferred arguments
+ */
+TEST(Formatter, Message)
+{
+    class Capture : public ILogger
+    {
+    public:
+        std::string last;
+
+        void Log(LogLevel, std::string_view message) override { last = message; }
+        [[nodiscard]] bool IsEnabled(LogLevel) const noexcept override { return true; }
+    } logger;
+
+    logger.LogInfo("{} at {} took {}", Point{3, 4}, Color::Red, [] { return std::chrono::milliseconds(12); });
+    EXPECT_EQ(logger.last, "(3,4) at 0 took 12ms");
+
+    details::Props props { std::pair{"level", LogLevel::Error}, std::pair{"ratio", 0.25} };
+    EXPECT_EQ(props.mapped["level"], "Error");
+    EXPECT_EQ(props.mapped["ratio"], "0.25");
+}
@@ -15,4 +15,21 @@ TEST(GLog, Log)
     std::cout.rdbuf(keeper);
 
     EXPECT_EQ(ss.str(), "[Info] test: Hello, World!\n");
-}
\ No newline at end of file
+}
+
+TEST(GLog, Macros)
+{
+    std::stringstream ss;
+
+    auto keeper = std::cout.rdbuf();
+    std::cout.rdbuf(ss.rdbuf());
+
+    for (int i = 0; i < 2; ++i)
+        CXLOG_INFO("macro", "Hello, {}!", i);
+    CXLOG_ERROR("macro", "Failed");
+    CXLOG_DEBUG("other", "No arguments");
+
+    std::cout.rdbuf(keeper);
+
+    EXPECT_EQ(ss.str(), "[Info] macro: Hello, 0!\n[Info] macro: Hello, 1!\n[Error] macro: Failed\n[Debug] other: No arguments\n");
+}
@@ -0,0 +1,77 @@
+#include "cxlog/LogContext.hpp"
+#include "cxlog/LoggerFactory.hpp"
+#include "cxlog/MemoryProvider.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace cxlog;
+
+class LogContextTest : public ::testing::Test
+{
+};
+
+TEST_F(LogContextTest, Scopes)
+{
+    PatternFormatter f("%X|%v");
+    std::string out;
+
+    {
+        ScopedContext outer{{"req", 42}, {"tenant", "acme"}};
+        {
+            ScopedContext inner{{"flag", true}};
+            f.Format(out, LogLevel::Info, "a");
+        }
+        out += ";";
+        f.Format(out, LogLevel::Info, "b");
+    }
+    out += ";";
+    f.Format(out, LogLevel::Info, "c");
+
+    EXPECT_EQ(out, "req=42 tenant=acme flag=true|a;req=42 tenant=acme|b;|c");
+}
+
+/**
+ * @brief %X{key} renders a single field, inner scopes shadowing outer ones
+ */
+TEST_F(LogContextTest, Field)
+{
+    PatternFormatter f("[%X{req}] [%X{missing}] %v");
+    std::string out;
+
+    ScopedContext outer{{"req", "outer"}};
+    ScopedContext inner{std::pair{"req", 1.5}};
+    f.Format(out, LogLevel::Info, "msg");
+
+    EXPECT_EQ(out, "[1.5] [] msg");
+}
+
+/**
+ * @brief Fields which do not fit into the per-thread buffer are dropped
+ */
+TEST_F(LogContextTest, Overflow)
+{
+    std::string big(ScopedContext::Capacity, 'x');
+
+    ScopedContext ctx{{"big", big}, {"small", 1}};
+
+    EXPECT_EQ(details::CurrentContext(), std::string("small\x1f" "1\x1e"));
+}
+
+/**
+ * @brief Context is captured at the call site, also when records are dispatched on another thread
+ */
+TEST_F(LogContextTest, Async)
+{
+    auto p = std::make_shared<MemoryProvider>(10, LogLevel::Trace, "%X %v");
+    {
+        LoggerOptions options;
+        options.Async = AsyncOptions{};
+        LoggerFactory factory({ p }, options);
+
+        auto l = factory.CreateLogger("test");
+        ScopedContext ctx{{"req", 7}};
+        l->LogInfo("msg");
+    }
+
+    EXPECT_EQ(p->LogLines(), std::vector<std::string>{"req=7 msg"});
+}
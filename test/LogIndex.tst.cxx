@@ -0,0 +1,154 @@
+#include "cxlog/LogIndex.hpp"
+#include "cxlog/FileProvider.hpp"
+
+#include <gtest/gtest.h>
+#include <fstream>
+
+using namespace cxlog;
+
+class LogIndexTest : public ::testing::Test
+{
+protected:
+    static constexpr const char* PATH = "/tmp/LogIndexTest/";
+
+    static std::string dumpFile(const std::filesystem::path& path) {
+        std::ifstream ifs(path);
+        return {
+                std::istreambuf_iterator<char>(ifs),
+                std::istreambuf_iterator<char>()
+        };
+    }
+
+    void SetUp() override {
+        std::filesystem::remove_all(PATH);
+        std::filesystem::create_directory(PATH);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(PATH);
+    }
+
+    static std::filesystem::path segment() {
+        for (const auto& entry : std::filesystem::directory_iterator(PATH))
+            if (entry.path().extension() == ".log")
+                return entry.path();
+        return {};
+    }
+};
+
+/**
+ * @brief Index blocks cover the whole segment, start on line boundaries and summarize their lines
+ */
+TEST_F(LogIndexTest, Blocks)
+{
+    {
+        FileProviderOptions opt;
+        opt.pattern = "[%l] %c: %v%n";
+        opt.index = true;
+        opt.indexBlockSize = 100;
+        FileProvider provider((std::filesystem::path(PATH)), opt);
+
+        auto info = provider.GetLogger("info");
+        auto error = provider.GetLogger("error");
+        for (int i = 0; i < 20; ++i)
+            info->Log(LogLevel::Info, "some message of a moderate size");
+        error->Log(LogLevel::Error, "failure");
+        for (int i = 0; i < 20; ++i)
+            info->Log(LogLevel::Info, "some message of a moderate size");
+    }
+
+    auto content = dumpFile(segment());
+    auto entries = ReadLogIndex(LogIndexPath(segment()));
+    ASSERT_GT(entries.size(), 5);
+
+    std::uint64_t offset = 0, lines = 0;
+    for (const auto& entry : entries)
+    {
+        EXPECT_EQ(entry.Offset, offset);
+        EXPECT_TRUE(entry.Offset == 0 || content[entry.Offset - 1] == '\n');
+        EXPECT_LE(entry.MinTime, entry.MaxTime);
+        offset += entry.Length;
+        lines += entry.Lines;
+    }
+    EXPECT_EQ(offset, content.size());
+    EXPECT_EQ(lines, 41);
+
+    LogIndexFilter filter;
+    filter.MinLevel = LogLevel::Error;
+
+    std::vector<std::string_view> matched;
+    for (const auto& entry : entries)
+        if (filter.MayMatch(entry))
+            matched.emplace_back(content.data() + entry.Offset, entry.Length);
+
+    ASSERT_EQ(matched.size(), 1);
+    EXPECT_NE(matched[0].find("[Error] error: failure"), std::string_view::npos);
+}
+
+TEST_F(LogIndexTest, Filter)
+{
+    auto now = std::chrono::system_clock::now();
+
+    LogIndexEntry entry;
+    entry.Add(LogLevel::Info, now, LogIndexEntry::CategoryBloom("db"), 10);
+    entry.Add(LogLevel::Warning, now + std::chrono::seconds(1), LogIndexEntry::CategoryBloom("net"), 10);
+
+    EXPECT_EQ(entry.Length, 20);
+    EXPECT_EQ(entry.Lines, 2);
+
+    LogIndexFilter filter;
+    EXPECT_TRUE(filter.MayMatch(entry));
+
+    filter.Category = "net";
+    EXPECT_TRUE(filter.MayMatch(entry));
+    filter.Category = "http";
+    EXPECT_FALSE(filter.MayMatch(entry));
+    filter.Category.reset();
+
+    filter.MinLevel = LogLevel::Warning;
+    EXPECT_TRUE(filter.MayMatch(entry));
+    filter.MinLevel = LogLevel::Error;
+    EXPECT_FALSE(filter.MayMatch(entry));
+    filter.MinLevel.reset();
+
+    filter.From = now + std::chrono::seconds(2);
+    EXPECT_FALSE(filter.MayMatch(entry));
+    filter.From = now - std::chrono::seconds(10);
+    filter.To = now - std::chrono::seconds(1);
+    EXPECT_FALSE(filter.MayMatch(entry));
+    filter.To = now;
+    EXPECT_TRUE(filter.MayMatch(entry));
+}
+
+/**
+ * @brief Lines of a block arriving out of timestamp order still bound the block by their earliest and latest times
+ */
+TEST_F(LogIndexTest, Filter_OutOfOrder)
+{
+    auto now = std::chrono::system_clock::now();
+
+    LogIndexEntry entry;
+    entry.Add(LogLevel::Info, now + std::chrono::seconds(1), LogIndexEntry::CategoryBloom("a"), 10);
+    entry.Add(LogLevel::Info, now + std::chrono::seconds(2), LogIndexEntry::CategoryBloom("b"), 10);
+    entry.Add(LogLevel::Info, now, LogIndexEntry::CategoryBloom("c"), 10);
+
+    EXPECT_EQ(entry.MinTime, std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count());
+
+    /* Only the middle timestamp is in range */
+    LogIndexFilter filter;
+    filter.From = now + std::chrono::milliseconds(500);
+    filter.To = now + std::chrono::milliseconds(1500);
+    EXPECT_TRUE(filter.MayMatch(entry));
+
+    filter.From = now + std::chrono::seconds(3);
+    filter.To.reset();
+    EXPECT_FALSE(filter.MayMatch(entry));
+}
+
+TEST_F(LogIndexTest, NotAnIndex)
+{
+    std::ofstream(std::string(PATH) + "bogus.idx") << "garbage";
+
+    EXPECT_THROW(ReadLogIndex(std::string(PATH) + "bogus.idx"), std::runtime_error);
+    EXPECT_THROW(ReadLogIndex(std::string(PATH) + "missing.idx"), std::runtime_error);
+}
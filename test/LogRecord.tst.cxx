@@ -0,0 +1,89 @@
+#include "cxlog/LogRecord.hpp"
+#include "cxlog/PatternFormatter.hpp"
+#include "cxlog/LoggerFactory.hpp"
+#include "cxlog/MemoryProvider.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace cxlog;
+
+class LogRecordTest : public ::testing::Test
+{
+};
+
+TEST_F(LogRecordTest, Make)
+{
+    auto before = std::chrono::system_clock::now();
+    auto record = LogRecord::Make(LogLevel::Warning, "cat", "msg", 7);
+
+    EXPECT_EQ(record.Level, LogLevel::Warning);
+    EXPECT_EQ(record.Category, "cat");
+    EXPECT_EQ(record.Message, "msg");
+    EXPECT_EQ(record.CategoryId, 7);
+    EXPECT_EQ(record.ThreadId, LogRecord::CurrentThreadId());
+    EXPECT_GE(record.Timestamp, before);
+}
+
+/**
+ * @brief Own() copies the borrowed message, so the record can outlive the caller's buffer
+ */
+TEST_F(LogRecordTest, Own)
+{
+    std::string message = "borrowed";
+    auto record = LogRecord::Make(LogLevel::Info, "cat", message);
+
+    record.Own();
+    message = "changed!";
+
+    ASSERT_NE(record.Storage, nullptr);
+    EXPECT_EQ(record.Message, "borrowed");
+    EXPECT_EQ(record.Message.data(), record.Storage->data());
+}
+
+/**
+ * @brief Rendering the same record with an equal layout reuses already rendered bytes
+ */
+TEST_F(LogRecordTest, Render_Shared)
+{
+    PatternFormatter f1("[%l] %v", "cat");
+    PatternFormatter f2("[%l] %v", "cat");
+    PatternFormatter f3("%v", "cat");
+
+    auto record = LogRecord::Make(LogLevel::Info, "cat", "msg");
+    auto first = record.Render(f1);
+    auto second = record.Render(f2);
+
+    EXPECT_EQ(first, "[Info] msg");
+    EXPECT_EQ(first.data(), second.data());
+    EXPECT_EQ(record.Render(f3), "msg");
+}
+
+/**
+ * @brief Rendering another record invalidates the cached line
+ */
+TEST_F(LogRecordTest, Render_Invalidated)
+{
+    PatternFormatter f("%v", "cat");
+
+    auto r1 = LogRecord::Make(LogLevel::Info, "cat", "first");
+    auto r2 = LogRecord::Make(LogLevel::Info, "cat", "second");
+
+    EXPECT_EQ(r1.Render(f), "first");
+    EXPECT_EQ(r2.Render(f), "second");
+    EXPECT_EQ(r1.Render(f), "first");
+}
+
+/**
+ * @brief Factory passes the same record to all providers
+ */
+TEST_F(LogRecordTest, FanOut)
+{
+    auto p1 = std::make_shared<MemoryProvider>(1);
+    auto p2 = std::make_shared<MemoryProvider>(1, LogLevel::Trace, "%c|%v");
+    LoggerFactory factory({ p1, p2 });
+
+    factory.CreateLogger("cat")->Log(LogLevel::Info, "msg");
+
+    EXPECT_EQ(p1->LogLines(), std::vector<std::string>{"[Info] cat: msg\n"});
+    EXPECT_EQ(p2->LogLines(), std::vector<std::string>{"cat|msg"});
+}
@@ -26,4 +26,78 @@ TEST_F(ILoggerTest, LogWarning)
     EXPECT_CALL(l, Log(LogLevel::Warning, "MyMessage 125 str"));
 
     l.LogWarning("MyMessage {} {}", 125, "str");
-}
\ No newline at end of file
+}
+
+TEST_F(ILoggerTest, Log_StringView)
+{
+    MockLogger l;
+    EXPECT_CALL(l, Log(LogLevel::Info, "view 1"));
+
+    std::string_view format = "view {}, ignored";
+    l.LogInfo(format.substr(0, 7), 1);
+}
+
+/**
+ * @brief Messages longer than the inline buffer spill over to the heap without being truncated
+ */
+TEST_F(ILoggerTest, Log_Long)
+{
+    const std::string part(details::MessageBuffer::InlineSize, 'x');
+
+    MockLogger l;
+    EXPECT_CALL(l, Log(LogLevel::Info, part + "-" + part));
+
+    l.LogInfo("{}-{}", part, part);
+}
+
+TEST_F(ILoggerTest, Log_Bytes)
+{
+    const std::byte bytes[] = { std::byte{'a'}, std::byte{'b'} };
+
+    MockLogger l;
+    EXPECT_CALL(l, Log(LogLevel::Info, "ab"));
+
+    l.Log(LogLevel::Info, bytes, std::size(bytes));
+}
+
+/**
+ * @brief Message logged while dispatching another one must not invalidate the outer message
+ */
+TEST_F(ILoggerTest, Log_Nested)
+{
+    const std::string part(details::MessageBuffer::InlineSize, 'x');
+    std::string seen;
+
+    MockLogger inner;
+    EXPECT_CALL(inner, Log(LogLevel::Debug, ::testing::_));
+
+    MockLogger outer;
+    EXPECT_CALL(outer, Log(LogLevel::Info, ::testing::_)).WillOnce([&](LogLevel, std::string_view message) {
+        inner.LogDebug("{}{}", part, part);
+        seen = message;
+    });
+
+    outer.LogInfo("{}{}", part, "outer");
+
+    EXPECT_EQ(seen, part + "outer");
+}
+
+/**
+ * @brief Callable arguments are invoked only when the message is logged
+ */
+TEST_F(ILoggerTest, Log_Lazy)
+{
+    MockLogger l;
+    int calls = 0;
+    auto dump = [&]{ ++calls; return std::string("state"); };
+
+    EXPECT_CALL(l, IsEnabled(LogLevel::Debug)).WillOnce(::testing::Return(false));
+    EXPECT_CALL(l, IsEnabled(LogLevel::Info)).WillOnce(::testing::Return(true));
+    EXPECT_CALL(l, Log(LogLevel::Info, "dump state 1"));
+
+    l.LogDebug("dump {} {}", dump, 1);
+    EXPECT_EQ(calls, 0);
+
+    l.LogInfo("dump {} {}", dump, 1);
+    EXPECT_EQ(calls, 1);
+}
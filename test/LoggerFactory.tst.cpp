@@ -13,6 +13,8 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 using namespace cxlog;
 
@@ -90,6 +92,24 @@ TEST_F(LoggerFactoryTest, CreateLogger_NoProviders)
     EXPECT_FALSE(logger->IsEnabled(LogLevel::Debug));
 }
 
+/**
+ * @brief Loggers may be created from several threads at once; all of them get the same instance
+ */
+TEST_F(LoggerFactoryTest, CreateLogger_Threads)
+{
+    LoggerFactory factory({ std::make_shared<MemoryProvider>(10) });
+
+    std::vector<std::shared_ptr<ILogger>> loggers(4);
+    std::vector<std::thread> threads;
+    for (auto& logger : loggers)
+        threads.emplace_back([&factory, &logger] { logger = factory.CreateLogger("test"); });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& logger : loggers)
+        EXPECT_EQ(logger, loggers[0]);
+}
+
 /**
  * @brief Tests AddProvider() function. This function should add a provider to the list of providers
  * and create an ILogger instance with this provider for all existing loggers.
@@ -266,6 +286,166 @@ TEST_F(LoggerFactoryTest, ExceptionHandling)
     EXPECT_NO_THROW(logger->Log(LogLevel::Debug, LOG_MESSAGE));
 }
 
+/**
+ * @brief Flush and Shutdown are forwarded to all providers
+ */
+TEST_F(LoggerFactoryTest, FlushShutdown)
+{
+    class CountingProvider : public ILoggerProvider
+    {
+    public:
+        int flushed {0};
+        int shutdown {0};
+
+        [[nodiscard]] std::string_view GetName() const override { return "CountingProvider"; }
+        std::shared_ptr<ILogger> GetLogger(const std::string &) override { return std::make_shared<MockLogger>(); }
+
+        std::future<void> Flush() override { ++flushed; return details::ReadyFuture(); }
+        std::future<void> Shutdown(std::chrono::steady_clock::time_point) override { ++shutdown; return details::ReadyFuture(); }
+    };
+
+    auto p1 = std::make_shared<CountingProvider>();
+    auto p2 = std::make_shared<CountingProvider>();
+    LoggerFactory factory({ p1, p2 });
+
+    factory.Flush().get();
+    factory.Shutdown(std::chrono::steady_clock::now()).get();
+
+    EXPECT_EQ(p1->flushed, 1);
+    EXPECT_EQ(p2->flushed, 1);
+    EXPECT_EQ(p1->shutdown, 1);
+    EXPECT_EQ(p2->shutdown, 1);
+}
+
+/**
+ * @brief Providers can be added while other threads log through existing loggers
+ */
+TEST_F(LoggerFactoryTest, AddProvider_Concurrent)
+{
+    LoggerFactory factory;
+    auto logger = factory.CreateLogger("MyLog");
+
+    std::atomic<bool> done {false};
+    std::thread writer([&] {
+        while (!done.load())
+            logger->Log(LogLevel::Info, LOG_MESSAGE);
+    });
+
+    std::vector<std::shared_ptr<MemoryProvider>> providers;
+    for (int i = 0; i < 50; ++i)
+    {
+        providers.push_back(std::make_shared<MemoryProvider>(1));
+        factory.AddProvider(providers.back());
+    }
+
+    done = true;
+    writer.join();
+
+    logger->Log(LogLevel::Info, LOG_MESSAGE);
+    for (const auto& p : providers)
+        EXPECT_EQ(p->LogLines().size(), 1);
+}
+
+/**
+ * @brief Flush, stats and Shutdown run while providers with queues of their own are being added
+ * @expects Every provider added before Shutdown has been flushed and shut down
+ */
+TEST_F(LoggerFactoryTest, AddProvider_ConcurrentFlush)
+{
+    LoggerFactory factory({}, { .Async = AsyncOptions { .Mode = DispatchMode::PerProvider } });
+    auto logger = factory.CreateLogger("MyLog");
+
+    std::atomic<bool> done {false};
+    std::thread flusher([&] {
+        while (!done.load())
+        {
+            logger->Log(LogLevel::Info, LOG_MESSAGE);
+            factory.Flush().get();
+            (void)factory.GetAsyncStats();
+        }
+    });
+
+    std::vector<std::shared_ptr<MemoryProvider>> providers;
+    for (int i = 0; i < 50; ++i)
+    {
+        providers.push_back(std::make_shared<MemoryProvider>(1));
+        factory.AddProvider(providers.back());
+    }
+
+    done = true;
+    flusher.join();
+    factory.Shutdown(std::chrono::steady_clock::now() + std::chrono::seconds(5)).get();
+}
+
+/**
+ * @brief Categories beyond MaxLoggers are evicted, least recently used first
+ * @expects Memory stays bounded; loggers held elsewhere keep working and are handed out again
+ */
+TEST_F(LoggerFactoryTest, Eviction_MaxLoggers)
+{
+    auto p = std::make_shared<MemoryProvider>(1000, LogLevel::Trace, "%c %v");
+    LoggerFactory factory({ p }, { .MaxLoggers = 8 });
+
+    auto held = factory.CreateLogger("held");
+    for (int i = 0; i < 100; ++i)
+        factory.CreateLogger("tenant-" + std::to_string(i))->Log(LogLevel::Info, LOG_MESSAGE);
+
+    auto usage = factory.GetMemoryUsage();
+    EXPECT_LE(usage.size(), 9);
+    EXPECT_GE(usage.size(), 7);
+    for (const auto& category : usage)
+        EXPECT_GT(category.Bytes, category.Category.size());
+
+    auto it = std::find_if(usage.begin(), usage.end(), [](const auto& c) { return c.Category == "held"; });
+    ASSERT_NE(it, usage.end());
+    EXPECT_EQ(factory.CreateLogger("held"), held);
+
+    held->Log(LogLevel::Info, "still here");
+    EXPECT_EQ(p->LogLines().back(), "held still here");
+}
+
+/**
+ * @brief Categories idle for longer than IdleTimeout are evicted, unless they have logged since
+ */
+TEST_F(LoggerFactoryTest, Eviction_Idle)
+{
+    auto p = std::make_shared<MemoryProvider>(10);
+    LoggerFactory factory({ p }, { .IdleTimeout = std::chrono::milliseconds(50) });
+
+    factory.CreateLogger("idle");
+    auto busy = factory.CreateLogger("busy");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    busy->Log(LogLevel::Info, LOG_MESSAGE);
+
+    EXPECT_EQ(factory.EvictIdleLoggers(), 1);
+
+    auto usage = factory.GetMemoryUsage();
+    ASSERT_EQ(usage.size(), 1);
+    EXPECT_EQ(usage[0].Category, "busy");
+    EXPECT_TRUE(usage[0].Cached);
+}
+
+/**
+ * @brief Provider lists replaced by AddProvider() are freed once nobody reads them
+ * @expects Memory of a logger grows linearly with its providers, not with every list published
+ */
+TEST_F(LoggerFactoryTest, AddProvider_PrunesLists)
+{
+    LoggerFactory factory;
+    auto logger = factory.CreateLogger("MyLog");
+
+    auto usage = [&] { return factory.GetMemoryUsage().at(0).Bytes; };
+    for (int i = 0; i < 64; ++i)
+        factory.AddProvider(std::make_shared<MemoryProvider>(1));
+    auto half = usage();
+    for (int i = 0; i < 64; ++i)
+        factory.AddProvider(std::make_shared<MemoryProvider>(1));
+
+    EXPECT_LT(usage(), 3 * half);
+    logger->Log(LogLevel::Info, LOG_MESSAGE);
+}
+
 TEST_F(LoggerFactoryTest, Common)
 {
     /* This will mute LogLevel::to_string() code coverage errors */
@@ -0,0 +1,95 @@
+#include "cxlog/PatternFormatter.hpp"
+#include "cxlog/MemoryProvider.hpp"
+
+#include <gtest/gtest.h>
+#include <regex>
+
+using namespace cxlog;
+
+class PatternFormatterTest : public ::testing::Test
+{
+};
+
+/**
+ * @brief Default pattern must match the historical "[Level] category: message" layout
+ */
+TEST_F(PatternFormatterTest, DefaultPattern)
+{
+    PatternFormatter f(PatternFormatter::DefaultPattern, "main");
+    std::string out;
+
+    f.Format(out, LogLevel::Info, "Hello");
+
+    EXPECT_EQ(out, "[Info] main: Hello\n");
+}
+
+/**
+ * @brief Format appends to the buffer, so that the caller can reuse its capacity
+ */
+TEST_F(PatternFormatterTest, Format_Appends)
+{
+    PatternFormatter f("%l|%v", "main");
+    std::string out = "x";
+
+    f.Format(out, LogLevel::Error, "msg");
+
+    EXPECT_EQ(out, "xError|msg");
+}
+
+TEST_F(PatternFormatterTest, Escapes)
+{
+    PatternFormatter f("100%% %c%n%q", "cat");
+    std::string out;
+
+    f.Format(out, LogLevel::Info, "");
+
+    EXPECT_EQ(out, "100% cat\n%q");
+}
+
+TEST_F(PatternFormatterTest, TimeFields)
+{
+    PatternFormatter f("%FT%T.%f %e [%t] %v", "cat");
+    std::string line;
+
+    f.Format(line, LogLevel::Info, "msg");
+
+    EXPECT_TRUE(std::regex_match(line, std::regex(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{6} \d{3} \[\d+\] msg)"))) << line;
+}
+
+/**
+ * @brief Formatters compiled from equal patterns share layout identity
+ */
+TEST_F(PatternFormatterTest, Layout)
+{
+    PatternFormatter f1("%l %v", "a");
+    PatternFormatter f2("%l %v", "b");
+    PatternFormatter f3("%v", "a");
+
+    EXPECT_EQ(f1.Layout(), f2.Layout());
+    EXPECT_NE(f1.Layout(), f3.Layout());
+}
+
+TEST_F(PatternFormatterTest, Provider)
+{
+    MemoryProvider provider(10, LogLevel::Trace, "%c/%l/%v");
+    provider.GetLogger("cat")->Log(LogLevel::Warning, "msg");
+
+    auto lines = provider.LogLines();
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0], "cat/Warning/msg");
+}
+
+TEST_F(PatternFormatterTest, ProcessId)
+{
+    PatternFormatter f("%P %v", "cat");
+    std::string line;
+
+    f.Format(line, LogLevel::Info, "msg");
+    EXPECT_EQ(line, std::to_string(LogRecord::CurrentProcessId()) + " msg");
+
+    auto record = LogRecord::Make(LogLevel::Info, "cat", "msg");
+    record.ProcessId = 4242;
+    line.clear();
+    f.Format(line, record);
+    EXPECT_EQ(line, "4242 msg");
+}
@@ -0,0 +1,100 @@
+#include "cxlog/SharedMemoryProvider.hpp"
+
+#include <gtest/gtest.h>
+#include <system_error>
+
+using namespace cxlog;
+
+class SharedMemoryProviderTest : public ::testing::Test
+{
+protected:
+    static constexpr const char* NAME = "/cxlog-SharedMemoryProviderTest";
+
+    static SharedMemoryProviderOptions Options(std::uint32_t slotCount)
+    {
+        SharedMemoryProviderOptions opt;
+        opt.slotCount = slotCount;
+        opt.slotSize = 128;
+        opt.pattern = "%l %v";
+        return opt;
+    }
+
+    static std::vector<std::string> ReadAll(SharedMemoryReader& reader)
+    {
+        std::vector<std::string> lines;
+        SharedMemoryReader::Record record;
+        for (auto status = reader.Read(record); status != SharedMemoryReader::Status::Empty; status = reader.Read(record))
+        {
+            if (status == SharedMemoryReader::Status::Ok && reader.Valid(record))
+                lines.emplace_back(record.Line);
+        }
+        return lines;
+    }
+};
+
+TEST_F(SharedMemoryProviderTest, ReadInOrder)
+{
+    SharedMemoryProvider provider(NAME, Options(16));
+    SharedMemoryReader reader(NAME);
+
+    auto l = provider.GetLogger("test");
+    l->Log(LogLevel::Info, "first");
+    l->Log(LogLevel::Error, "second");
+
+    SharedMemoryReader::Record record;
+    ASSERT_EQ(reader.Read(record), SharedMemoryReader::Status::Ok);
+    EXPECT_EQ(record.Sequence, 0);
+    EXPECT_EQ(record.Level, LogLevel::Info);
+    EXPECT_EQ(record.Line, "Info first");
+    EXPECT_TRUE(reader.Valid(record));
+
+    ASSERT_EQ(reader.Read(record), SharedMemoryReader::Status::Ok);
+    EXPECT_EQ(record.Line, "Error second");
+    EXPECT_EQ(reader.Read(record), SharedMemoryReader::Status::Empty);
+}
+
+/**
+ * @brief Writers never wait for the reader; a lapped reader skips to the oldest record still available
+ */
+TEST_F(SharedMemoryProviderTest, Lapped)
+{
+    SharedMemoryProvider provider(NAME, Options(4));
+    SharedMemoryReader reader(NAME);
+
+    auto l = provider.GetLogger("test");
+    for (int i = 0; i < 10; ++i)
+        l->LogInfo("{}", i);
+
+    EXPECT_EQ(ReadAll(reader), (std::vector<std::string>{"Info 6", "Info 7", "Info 8", "Info 9"}));
+    EXPECT_EQ(reader.Lost(), 6);
+
+    /* Record kept by the reader is detected as overwritten */
+    SharedMemoryReader late(NAME);
+    SharedMemoryReader::Record record;
+    ASSERT_EQ(late.Read(record), SharedMemoryReader::Status::Ok);
+    l->LogInfo("{}", 10);
+    EXPECT_FALSE(late.Valid(record));
+}
+
+TEST_F(SharedMemoryProviderTest, Truncated)
+{
+    SharedMemoryProvider provider(NAME, Options(4));
+    SharedMemoryReader reader(NAME, false);
+
+    provider.GetLogger("test")->Log(LogLevel::Info, std::string(200, 'x'));
+
+    auto lines = ReadAll(reader);
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0].size(), 128 - 32);
+}
+
+TEST_F(SharedMemoryProviderTest, InvalidOptions)
+{
+    EXPECT_THROW(SharedMemoryProvider(NAME, Options(3)), std::invalid_argument);
+
+    auto opt = Options(4);
+    opt.slotSize = 100;
+    EXPECT_THROW(SharedMemoryProvider(NAME, opt), std::invalid_argument);
+
+    EXPECT_THROW(SharedMemoryReader("/cxlog-missing-ring"), std::system_error);
+}
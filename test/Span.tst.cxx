@@ -0,0 +1,110 @@
+#include "cxlog/Span.hpp"
+#include "cxlog/TraceEventProvider.hpp"
+#include "cxlog/LoggerFactory.hpp"
+#include "cxlog/MemoryProvider.hpp"
+#include "mocks/MockLogger.hpp"
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <regex>
+#include <thread>
+
+using namespace cxlog;
+
+class SpanTest : public ::testing::Test
+{
+protected:
+    static constexpr const char* PATH = "/tmp/SpanTest.json";
+
+    static std::string dumpFile(const std::filesystem::path& path) {
+        std::ifstream ifs(path);
+        return {
+                std::istreambuf_iterator<char>(ifs),
+                std::istreambuf_iterator<char>()
+        };
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(PATH);
+    }
+};
+
+/**
+ * @brief Span logs its name and duration once it goes out of scope
+ */
+TEST_F(SpanTest, LogsDuration)
+{
+    auto p = std::make_shared<MemoryProvider>(10, LogLevel::Trace, "%l %v %D");
+    LoggerFactory factory({ p });
+    auto l = factory.CreateLogger("test");
+
+    {
+        Span span(l, "db.query");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    auto lines = p->LogLines();
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_TRUE(std::regex_match(lines[0], std::regex(R"(Debug db\.query \d+us)"))) << lines[0];
+
+    auto micros = std::stoi(lines[0].substr(std::string("Debug db.query ").size()));
+    EXPECT_GE(micros, 2000);
+}
+
+/**
+ * @brief Disabled span never logs, ended span logs only once
+ */
+TEST_F(SpanTest, DisabledAndEnded)
+{
+    MockLogger l;
+    EXPECT_CALL(l, IsEnabled(LogLevel::Trace)).WillOnce(::testing::Return(false));
+    EXPECT_CALL(l, IsEnabled(LogLevel::Debug)).WillOnce(::testing::Return(true));
+    EXPECT_CALL(l, Log(LogLevel::Debug, "ended")).Times(1);
+
+    {
+        Span disabled(l, "disabled", LogLevel::Trace);
+        Span ended(l, "ended");
+        ended.End();
+    }
+}
+
+/**
+ * @brief Spans and messages of multiple threads end up in a single trace-event JSON array
+ */
+TEST_F(SpanTest, TraceEventProvider)
+{
+    {
+        TraceEventProviderOptions opt;
+        opt.bufferSize = 256;
+
+        LoggerFactory factory({ std::make_shared<TraceEventProvider>(PATH, opt) });
+        auto l = factory.CreateLogger("test");
+
+        auto work = [&] {
+            for (int i = 0; i < 10; ++i)
+            {
+                Span span(l, "work");
+                l->LogInfo("step \"{}\"", i);
+            }
+        };
+
+        std::thread t(work);
+        work();
+        t.join();
+    }
+
+    auto json = dumpFile(PATH);
+    ASSERT_GE(json.size(), 4);
+    EXPECT_EQ(json.substr(0, 3), "[\n{");
+    EXPECT_EQ(json.substr(json.size() - 4), "}\n]\n");
+
+    std::regex span(R"(\{"name":"work","cat":"test","ph":"X","ts":\d+\.\d{3},"dur":\d+\.\d{3},"pid":\d+,"tid":\d+,"args":\{"level":"Debug"\}\})");
+    std::regex instant(R"(\{"name":"step \\"\d\\"","cat":"test","ph":"i","s":"t","ts":\d+\.\d{3},"pid":\d+,"tid":\d+,"args":\{"level":"Info"\}\})");
+
+    auto count = [&](const std::regex& re) {
+        return std::distance(std::sregex_iterator(json.begin(), json.end(), re), std::sregex_iterator());
+    };
+    EXPECT_EQ(count(span), 20);
+    EXPECT_EQ(count(instant), 20);
+    EXPECT_EQ(std::count(json.begin(), json.end(), '\n'), 42);
+}
@@ -6,7 +6,12 @@
 class MockLogger : public cxlog::ILogger
 {
 public:
-    MOCK_METHOD(void, Log, (cxlog::LogLevel level, const std::string& message), (override));
+    MockLogger()
+    {
+        ON_CALL(*this, IsEnabled).WillByDefault(::testing::Return(true));
+    }
+
+    MOCK_METHOD(void, Log, (cxlog::LogLevel level, std::string_view message), (override));
     MOCK_METHOD(bool, IsEnabled, (cxlog::LogLevel level), (const, noexcept, override));
 
     using cxlog::ILogger::Log;
@@ -0,0 +1,43 @@
+#pragma once
+#include "cxlog/LogLevel.hpp"
+
+#include <optional>
+#include <string_view>
+
+/* Parsing of the "[%l] %c: %v" line layout, shared by the command line tools */
+namespace cxlog::tools
+{
+    inline std::optional<LogLevel> ParseLevel(std::string_view text)
+    {
+        for (int i = static_cast<int>(LogLevel::Trace); i <= static_cast<int>(LogLevel::Critical); ++i)
+            if (text == to_string(static_cast<LogLevel>(i)))
+                return static_cast<LogLevel>(i);
+
+        return std::nullopt;
+    }
+
+    /* Extracts level and category from a "[%l] %c: " prefix anywhere in the line */
+    inline bool ParseLine(std::string_view line, LogLevel& level, std::string_view& category)
+    {
+        for (auto open = line.find('['); open != std::string_view::npos; open = line.find('[', open + 1))
+        {
+            auto close = line.find("] ", open);
+            if (close == std::string_view::npos)
+                return false;
+
+            auto parsed = ParseLevel(line.substr(open + 1, close - open - 1));
+            if (!parsed)
+                continue;
+
+            auto rest = line.substr(close + 2);
+            auto colon = rest.find(": ");
+            if (colon == std::string_view::npos)
+                return false;
+
+            level = *parsed;
+            category = rest.substr(0, colon);
+            return true;
+        }
+        return false;
+    }
+}
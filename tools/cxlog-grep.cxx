@@ -0,0 +1,424 @@
+/*
+ * cxlog-grep - parallel literal search over directories of rotated log files
+ *
+ * Files are mapped and split into line aligned chunks, which are scanned by a pool of threads. Needles are found
+ * with AVX2 where the CPU supports it (memchr based scalar search otherwise), and level/category predicates are
+ * evaluated on the "[%l] %c: " prefix without regular expressions. Matches of all files are merged in timestamp
+ * order; lines which don't start with a timestamp are ordered by the creation time of their file.
+ */
+#include "LogLine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CXLOG_GREP_AVX2 1
+#endif
+
+using namespace cxlog;
+using namespace cxlog::tools;
+
+namespace
+{
+    constexpr std::size_t ChunkSize = 8 * 1024 * 1024;
+
+    struct Options
+    {
+        std::string needle;
+        std::optional<LogLevel> minLevel;
+        std::optional<std::string> category;
+        unsigned jobs {std::max(1u, std::thread::hardware_concurrency())};
+        bool count {false};
+        std::vector<std::filesystem::path> files;
+    };
+
+    struct MappedFile
+    {
+        std::string_view data;
+        std::string fallbackKey;    /**< Sort key for lines without a timestamp, from the file name */
+
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile()
+        {
+            if (!data.empty())
+                ::munmap(const_cast<char*>(data.data()), data.size());
+        }
+    };
+
+    struct Chunk
+    {
+        std::size_t file;
+        std::string_view data;
+        std::vector<std::string_view> matches;
+    };
+
+    [[noreturn]] void Usage(const char* error = nullptr)
+    {
+        if (error)
+            std::cerr << "cxlog-grep: " << error << "\n";
+
+        std::cerr << "usage: cxlog-grep [--level LEVEL] [--category NAME] [--jobs N] [--count] [NEEDLE] PATH...\n"
+                     "  LEVEL   minimum level: Trace, Debug, Info, Warning, Error or Critical\n"
+                     "  NEEDLE  literal text to look for\n"
+                     "  PATH    log file or directory of log files\n";
+        std::exit(2);
+    }
+
+    Options ParseArgs(int argc, char** argv)
+    {
+        Options options;
+        std::vector<std::string> positional;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (++i == argc)
+                    Usage("missing argument value");
+                return argv[i];
+            };
+
+            if (arg == "--level")
+            {
+                options.minLevel = ParseLevel(value());
+                if (!options.minLevel)
+                    Usage("invalid level");
+            }
+            else if (arg == "--category")
+                options.category = value();
+            else if (arg == "--jobs")
+                options.jobs = static_cast<unsigned>(std::max(1, std::atoi(value().c_str())));
+            else if (arg == "--count")
+                options.count = true;
+            else if (arg.rfind("--", 0) == 0)
+                Usage("unknown option");
+            else
+                positional.push_back(arg);
+        }
+
+        /* First positional argument is the needle, unless it names an existing path */
+        if (!positional.empty() && !std::filesystem::exists(positional.front()))
+        {
+            options.needle = positional.front();
+            positional.erase(positional.begin());
+        }
+
+        for (const auto& path : positional)
+        {
+            if (std::filesystem::is_directory(path))
+            {
+                for (const auto& entry : std::filesystem::directory_iterator(path))
+                    if (entry.path().extension() == ".log")
+                        options.files.push_back(entry.path());
+            }
+            else
+                options.files.emplace_back(path);
+        }
+
+        if (options.files.empty())
+            Usage("no log files given");
+
+        std::sort(options.files.begin(), options.files.end());
+        return options;
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Literal search ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    const char* FindScalar(const char* begin, const char* end, std::string_view needle)
+    {
+        const auto n = needle.size();
+        while (static_cast<std::size_t>(end - begin) >= n)
+        {
+            auto hit = static_cast<const char*>(std::memchr(begin, needle[0], static_cast<std::size_t>(end - begin) - n + 1));
+            if (!hit)
+                return nullptr;
+            if (std::memcmp(hit + 1, needle.data() + 1, n - 1) == 0)
+                return hit;
+            begin = hit + 1;
+        }
+        return nullptr;
+    }
+
+#ifdef CXLOG_GREP_AVX2
+    /* Compares first and last needle characters 32 positions at a time, verifying candidates with memcmp */
+    __attribute__((target("avx2")))
+    const char* FindAvx2(const char* begin, const char* end, std::string_view needle)
+    {
+        const auto n = needle.size();
+        const __m256i first = _mm256_set1_epi8(needle.front());
+        const __m256i last = _mm256_set1_epi8(needle.back());
+
+        const char* p = begin;
+        for (; end - p >= static_cast<std::ptrdiff_t>(n + 31); p += 32)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + n - 1));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+
+            while (mask)
+            {
+                auto bit = __builtin_ctz(mask);
+                if (std::memcmp(p + bit + 1, needle.data() + 1, n - 2) == 0)
+                    return p + bit;
+                mask &= mask - 1;
+            }
+        }
+        return FindScalar(p, end, needle);
+    }
+#endif
+
+    using FindFn = const char* (*)(const char*, const char*, std::string_view);
+
+    FindFn SelectFind(std::string_view needle)
+    {
+#ifdef CXLOG_GREP_AVX2
+        if (needle.size() >= 2 && __builtin_cpu_supports("avx2"))
+            return FindAvx2;
+#endif
+        return FindScalar;
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Scanning ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    const char* LineStart(const char* begin, const char* p)
+    {
+        while (p > begin && p[-1] != '\n')
+            --p;
+        return p;
+    }
+
+    const char* LineEnd(const char* p, const char* end)
+    {
+        auto nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        return nl ? nl + 1 : end;
+    }
+
+    bool Accept(std::string_view line, const Options& options)
+    {
+        if (!options.minLevel && !options.category)
+            return true;
+
+        LogLevel level;
+        std::string_view category;
+        if (!ParseLine(line, level, category))
+            return false;
+
+        return (!options.minLevel || level >= *options.minLevel)
+            && (!options.category || category == *options.category);
+    }
+
+    void ScanChunk(Chunk& chunk, const Options& options, FindFn find)
+    {
+        const char* begin = chunk.data.data();
+        const char* end = begin + chunk.data.size();
+
+        for (const char* p = begin; p < end;)
+        {
+            const char* lineBegin = p;
+            if (!options.needle.empty())
+            {
+                auto hit = find(p, end, options.needle);
+                if (!hit)
+                    break;
+                lineBegin = LineStart(begin, hit);
+            }
+
+            const char* lineEnd = LineEnd(lineBegin, end);
+            std::string_view line(lineBegin, static_cast<std::size_t>(lineEnd - lineBegin));
+            if (Accept(line, options))
+                chunk.matches.push_back(line);
+
+            p = lineEnd;
+        }
+    }
+
+    bool MapFile(const std::filesystem::path& path, MappedFile& file)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            std::perror(("cxlog-grep: " + path.string()).c_str());
+            return false;
+        }
+
+        struct stat st {};
+        ::fstat(fd, &st);
+        auto size = static_cast<std::size_t>(st.st_size);
+
+        if (size > 0)
+        {
+            void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                ::madvise(mapped, size, MADV_SEQUENTIAL);
+                file.data = std::string_view(static_cast<const char*>(mapped), size);
+            }
+            else
+                std::perror(("cxlog-grep: " + path.string()).c_str());
+        }
+
+        ::close(fd);
+        return true;
+    }
+
+    /* Splits a file into chunks ending on line boundaries */
+    void SplitFile(std::size_t index, std::string_view data, std::vector<Chunk>& chunks)
+    {
+        while (!data.empty())
+        {
+            auto size = std::min(ChunkSize, data.size());
+            if (size < data.size())
+            {
+                auto nl = data.find('\n', size - 1);
+                size = nl == std::string_view::npos ? data.size() : nl + 1;
+            }
+
+            chunks.push_back({index, data.substr(0, size), {}});
+            data.remove_prefix(size);
+        }
+    }
+
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ Merging ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    /* Digits of a leading "YYYY-MM-DD HH:MM:SS.ffffff" style timestamp, so differently punctuated times compare */
+    std::string TimeKey(std::string_view text)
+    {
+        std::string key;
+        if (text.size() < 10 || !std::isdigit(static_cast<unsigned char>(text[0])) || text[4] != '-' || text[7] != '-')
+            return key;
+
+        for (char c : text.substr(0, 32))
+        {
+            if (std::isdigit(static_cast<unsigned char>(c)))
+                key.push_back(c);
+            else if (c == ' ' && key.size() > 8)
+                break;
+        }
+        return key;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto options = ParseArgs(argc, argv);
+    auto find = SelectFind(options.needle);
+
+    std::vector<MappedFile> files(options.files.size());
+    std::vector<Chunk> chunks;
+
+    for (std::size_t i = 0; i < options.files.size(); ++i)
+    {
+        if (!MapFile(options.files[i], files[i]))
+            continue;
+
+        files[i].fallbackKey = TimeKey(options.files[i].filename().string());
+        SplitFile(i, files[i].data, chunks);
+    }
+
+    /* Chunks are handed out to the workers in order */
+    std::atomic<std::size_t> next {0};
+    auto worker = [&] {
+        for (auto i = next++; i < chunks.size(); i = next++)
+            ScanChunk(chunks[i], options, find);
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < std::min<std::size_t>(options.jobs, chunks.size()); ++i)
+        pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool)
+        thread.join();
+
+    std::size_t total = 0;
+    auto emit = [&](std::string_view line) {
+        ++total;
+        if (!options.count)
+        {
+            std::fwrite(line.data(), 1, line.size(), stdout);
+            if (line.back() != '\n')
+                std::fputc('\n', stdout);
+        }
+    };
+
+    /* Chunks are already in order within a file, so a single file (or a count) needs no merging */
+    if (files.size() == 1 || options.count)
+    {
+        for (const auto& chunk : chunks)
+            for (auto line : chunk.matches)
+                emit(line);
+    }
+    else
+    {
+        /* K-way merge across files by timestamp */
+        struct Cursor
+        {
+            std::size_t file;
+            std::size_t chunk;
+            std::size_t match;
+            std::string key;
+        };
+
+        auto later = [](const Cursor& a, const Cursor& b) {
+            return a.key != b.key ? a.key > b.key : a.file > b.file;
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap(later);
+
+        auto advance = [&](Cursor cursor) {
+            while (cursor.chunk < chunks.size() && chunks[cursor.chunk].file == cursor.file)
+            {
+                const auto& matches = chunks[cursor.chunk].matches;
+                if (cursor.match < matches.size())
+                {
+                    cursor.key = TimeKey(matches[cursor.match]);
+                    if (cursor.key.empty())
+                        cursor.key = files[cursor.file].fallbackKey;
+                    heap.push(std::move(cursor));
+                    return;
+                }
+                ++cursor.chunk;
+                cursor.match = 0;
+            }
+        };
+
+        for (std::size_t c = 0; c < chunks.size(); ++c)
+            if (c == 0 || chunks[c].file != chunks[c - 1].file)
+                advance({chunks[c].file, c, 0, {}});
+
+        while (!heap.empty())
+        {
+            auto cursor = heap.top();
+            heap.pop();
+
+            emit(chunks[cursor.chunk].matches[cursor.match]);
+
+            ++cursor.match;
+            advance(std::move(cursor));
+        }
+    }
+
+    if (options.count)
+        std::printf("%zu\n", total);
+
+    std::fflush(stdout);
+    return total > 0 ? 0 : 1;
+}
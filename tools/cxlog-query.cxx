@@ -0,0 +1,252 @@
+/*
+ * cxlog-query - searches FileProvider output by time, level and category
+ *
+ * Segments written with FileProviderOptions::index carry a sidecar index, which is used to map and scan only
+ * the blocks that may contain matching lines. Segments without an index are scanned as a whole.
+ *
+ * Level and category are matched per line for layouts containing "[%l] %c: " (the default layout); time is
+ * matched per index block.
+ */
+#include "cxlog/LogIndex.hpp"
+#include "LogLine.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace cxlog;
+using namespace cxlog::tools;
+
+namespace
+{
+    struct Query
+    {
+        LogIndexFilter filter;
+        std::vector<std::filesystem::path> segments;
+        bool stats {false};
+    };
+
+    struct Stats
+    {
+        std::uint64_t blocks {0};
+        std::uint64_t scannedBlocks {0};
+        std::uint64_t scannedBytes {0};
+        std::uint64_t lines {0};
+    };
+
+    [[noreturn]] void Usage(const char* error = nullptr)
+    {
+        if (error)
+            std::cerr << "cxlog-query: " << error << "\n";
+
+        std::cerr << "usage: cxlog-query [--from TIME] [--to TIME] [--level LEVEL] [--category NAME] [--stats] PATH...\n"
+                     "  TIME   seconds since epoch or local 'YYYY-MM-DD HH:MM:SS'\n"
+                     "  LEVEL  minimum level: Trace, Debug, Info, Warning, Error or Critical\n"
+                     "  PATH   log segment or directory of segments\n";
+        std::exit(2);
+    }
+
+    std::chrono::system_clock::time_point ParseTime(const std::string& text)
+    {
+        std::tm tm {};
+        char separator = 0;
+        if (std::sscanf(text.c_str(), "%d-%d-%d%c%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &separator,
+                        &tm.tm_hour, &tm.tm_min, &tm.tm_sec) == 7)
+        {
+            tm.tm_year -= 1900;
+            tm.tm_mon -= 1;
+            tm.tm_isdst = -1;
+            return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+        }
+
+        char* end = nullptr;
+        auto seconds = std::strtoll(text.c_str(), &end, 10);
+        if (end == text.c_str() || *end != '\0')
+            Usage("invalid time");
+
+        return std::chrono::system_clock::from_time_t(static_cast<std::time_t>(seconds));
+    }
+
+    Query ParseArgs(int argc, char** argv)
+    {
+        Query query;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (++i == argc)
+                    Usage("missing argument value");
+                return argv[i];
+            };
+
+            if (arg == "--from")
+                query.filter.From = ParseTime(value());
+            else if (arg == "--to")
+                query.filter.To = ParseTime(value());
+            else if (arg == "--level")
+            {
+                query.filter.MinLevel = ParseLevel(value());
+                if (!query.filter.MinLevel)
+                    Usage("invalid level");
+            }
+            else if (arg == "--category")
+                query.filter.Category = value();
+            else if (arg == "--stats")
+                query.stats = true;
+            else if (arg.rfind("--", 0) == 0)
+                Usage("unknown option");
+            else if (std::filesystem::is_directory(arg))
+            {
+                for (const auto& entry : std::filesystem::directory_iterator(arg))
+                    if (entry.path().extension() == ".log")
+                        query.segments.push_back(entry.path());
+            }
+            else
+                query.segments.emplace_back(arg);
+        }
+
+        if (query.segments.empty())
+            Usage("no log segments given");
+
+        /* Segment names start with their creation time, so sorting by name orders the output by time */
+        std::sort(query.segments.begin(), query.segments.end());
+        return query;
+    }
+
+    /* Prints matching lines of a mapped range. Lines without a prefix continue the previous message. */
+    void Scan(std::string_view data, const LogIndexFilter& filter, Stats& stats)
+    {
+        bool matching = false;
+        while (!data.empty())
+        {
+            auto end = data.find('\n');
+            auto line = data.substr(0, end == std::string_view::npos ? data.size() : end + 1);
+            data.remove_prefix(line.size());
+
+            LogLevel level;
+            std::string_view category;
+            if (ParseLine(line, level, category))
+            {
+                matching = (!filter.MinLevel || level >= *filter.MinLevel)
+                        && (!filter.Category || category == *filter.Category);
+            }
+            else if (!filter.MinLevel && !filter.Category)
+            {
+                matching = true;
+            }
+
+            if (matching)
+            {
+                std::fwrite(line.data(), 1, line.size(), stdout);
+                ++stats.lines;
+            }
+        }
+    }
+
+    /* Maps a byte range of the segment; mappings must start on a page boundary */
+    void ScanRange(int fd, std::uint64_t offset, std::uint64_t length, const LogIndexFilter& filter, Stats& stats)
+    {
+        if (length == 0)
+            return;
+
+        static const auto pageSize = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+        auto aligned = offset / pageSize * pageSize;
+        auto mappedLength = length + (offset - aligned);
+
+        void* mapped = ::mmap(nullptr, mappedLength, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(aligned));
+        if (mapped == MAP_FAILED)
+        {
+            std::perror("cxlog-query: mmap");
+            return;
+        }
+
+        ::madvise(mapped, mappedLength, MADV_SEQUENTIAL);
+        Scan(std::string_view(static_cast<const char*>(mapped) + (offset - aligned), length), filter, stats);
+        ::munmap(mapped, mappedLength);
+
+        stats.scannedBytes += length;
+    }
+
+    void QuerySegment(const std::filesystem::path& segment, const LogIndexFilter& filter, Stats& stats)
+    {
+        int fd = ::open(segment.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            std::perror(("cxlog-query: " + segment.string()).c_str());
+            return;
+        }
+
+        struct stat st {};
+        ::fstat(fd, &st);
+        auto size = static_cast<std::uint64_t>(st.st_size);
+
+        std::vector<LogIndexEntry> entries;
+        try
+        {
+            entries = ReadLogIndex(LogIndexPath(segment));
+        }
+        catch (const std::exception&)
+        {
+            /* No usable index, scan everything */
+        }
+
+        std::uint64_t indexed = 0;
+        std::uint64_t rangeStart = 0, rangeEnd = 0;
+
+        for (const auto& entry : entries)
+        {
+            ++stats.blocks;
+            indexed = std::max(indexed, entry.Offset + entry.Length);
+            if (!filter.MayMatch(entry) || entry.Offset + entry.Length > size)
+                continue;
+
+            ++stats.scannedBlocks;
+
+            /* Adjacent blocks are mapped and scanned as one range */
+            if (entry.Offset != rangeEnd)
+            {
+                ScanRange(fd, rangeStart, rangeEnd - rangeStart, filter, stats);
+                rangeStart = entry.Offset;
+            }
+            rangeEnd = entry.Offset + entry.Length;
+        }
+        ScanRange(fd, rangeStart, rangeEnd - rangeStart, filter, stats);
+
+        /* Tail not covered by the index yet (segment still being written, or no index at all) */
+        if (size > indexed)
+            ScanRange(fd, indexed, size - indexed, filter, stats);
+
+        ::close(fd);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto query = ParseArgs(argc, argv);
+
+    Stats stats;
+    for (const auto& segment : query.segments)
+        QuerySegment(segment, query.filter, stats);
+
+    std::fflush(stdout);
+
+    if (query.stats)
+    {
+        std::cerr << "segments: " << query.segments.size()
+                  << ", blocks scanned: " << stats.scannedBlocks << "/" << stats.blocks
+                  << ", bytes scanned: " << stats.scannedBytes
+                  << ", lines: " << stats.lines << "\n";
+    }
+
+    return 0;
+}
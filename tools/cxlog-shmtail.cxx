@@ -0,0 +1,132 @@
+/*
+ * cxlog-shmtail - prints lines published by a SharedMemoryProvider as they arrive
+ *
+ * Lines are read in place from the shared ring and appended to an output buffer; a line which got overwritten
+ * while being copied is dropped from the buffer again and reported as lost.
+ */
+#include "cxlog/SharedMemoryProvider.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace cxlog;
+
+namespace
+{
+    [[noreturn]] void Usage(const char* error = nullptr)
+    {
+        if (error)
+            std::cerr << "cxlog-shmtail: " << error << "\n";
+
+        std::cerr << "usage: cxlog-shmtail [--new] [--once] NAME\n"
+                     "  --new   skip records already in the ring\n"
+                     "  --once  exit once the ring has been drained, instead of following it\n"
+                     "  NAME    shared memory object name, e.g. /myapp-log\n";
+        std::exit(2);
+    }
+
+    void WriteAll(const char* data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            auto written = ::write(STDOUT_FILENO, data, size);
+            if (written <= 0)
+                std::exit(1);
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool fromOldest = true, once = false;
+    std::string name;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--new")
+            fromOldest = false;
+        else if (arg == "--once")
+            once = true;
+        else if (arg.rfind("--", 0) == 0 || !name.empty())
+            Usage("invalid argument");
+        else
+            name = arg;
+    }
+
+    if (name.empty())
+        Usage("no ring name given");
+
+    std::unique_ptr<SharedMemoryReader> reader;
+    try
+    {
+        reader = std::make_unique<SharedMemoryReader>(name, fromOldest);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "cxlog-shmtail: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::vector<char> out(256 * 1024);
+    std::size_t used = 0;
+    std::uint64_t torn = 0, reported = 0;
+    auto idle = std::chrono::microseconds(50);
+
+    for (;;)
+    {
+        SharedMemoryReader::Record record;
+        auto status = reader->Read(record);
+
+        if (status == SharedMemoryReader::Status::Ok)
+        {
+            idle = std::chrono::microseconds(50);
+            if (used + record.Line.size() > out.size())
+            {
+                WriteAll(out.data(), used);
+                used = 0;
+            }
+
+            auto size = std::min(record.Line.size(), out.size());
+            std::memcpy(out.data() + used, record.Line.data(), size);
+
+            /* Keep the copy only if the producer did not overwrite the slot meanwhile */
+            if (reader->Valid(record))
+                used += size;
+            else
+                ++torn;
+            continue;
+        }
+
+        if (reader->Lost() + torn != reported)
+        {
+            WriteAll(out.data(), used);
+            used = 0;
+            std::cerr << "cxlog-shmtail: lost " << reader->Lost() + torn - reported << " records\n";
+            reported = reader->Lost() + torn;
+        }
+
+        if (status == SharedMemoryReader::Status::Lapped)
+            continue;
+
+        /* Ring drained */
+        WriteAll(out.data(), used);
+        used = 0;
+        if (once)
+            break;
+
+        std::this_thread::sleep_for(idle);
+        idle = std::min<std::chrono::microseconds>(idle * 2, std::chrono::milliseconds(10));
+    }
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+/*
+ * cxlogd - collects logs of local processes using DaemonProvider into a single rotated file pipeline
+ *
+ * Clients connect over a SOCK_SEQPACKET Unix socket and send whole batches per message. Records of all clients
+ * are stamped with the client's process id (from the socket peer credentials) and written through one
+ * FileProvider, so the host has a single set of log files and one buffered writer instead of one per process.
+ */
+#include "cxlog/DaemonProtocol.hpp"
+#include "cxlog/FileProvider.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace cxlog;
+
+namespace
+{
+    volatile std::sig_atomic_t gStop = 0;
+
+    struct Client
+    {
+        int fd;
+        std::uint32_t pid;
+    };
+
+    [[noreturn]] void Usage(const char* error = nullptr)
+    {
+        if (error)
+            std::cerr << "cxlogd: " << error << "\n";
+
+        std::cerr << "usage: cxlogd [--socket PATH] [--dir DIR] [--pattern PATTERN] [--split daily|N] [--index]\n"
+                     "  PATH     socket to listen on (default /tmp/cxlogd.sock)\n"
+                     "  DIR      directory to write log files into (default current directory)\n"
+                     "  PATTERN  line layout (default \"%F %T.%f %P [%l] %c: %v%n\")\n"
+                     "  --split  start a new file every day, or every N messages\n"
+                     "  --index  write sidecar indexes for cxlog-query\n";
+        std::exit(2);
+    }
+
+    int Listen(const std::string& path)
+    {
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+            Usage("socket path too long");
+        std::copy(path.begin(), path.end(), address.sun_path);
+
+        int fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        ::unlink(path.c_str());
+        if (fd < 0 || ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 128) != 0)
+        {
+            std::perror("cxlogd: listen");
+            std::exit(1);
+        }
+        return fd;
+    }
+
+    std::uint32_t PeerPid(int fd)
+    {
+        ucred credentials {};
+        socklen_t length = sizeof(credentials);
+        if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0)
+            return 0;
+        return static_cast<std::uint32_t>(credentials.pid);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string socketPath = "/tmp/cxlogd.sock";
+    std::filesystem::path dir = std::filesystem::current_path();
+    FileProviderOptions opt;
+    opt.pattern = "%F %T.%f %P [%l] %c: %v%n";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (++i == argc)
+                Usage("missing argument value");
+            return argv[i];
+        };
+
+        if (arg == "--socket")
+            socketPath = value();
+        else if (arg == "--dir")
+            dir = value();
+        else if (arg == "--pattern")
+            opt.pattern = value();
+        else if (arg == "--index")
+            opt.index = true;
+        else if (arg == "--split")
+        {
+            auto split = value();
+            if (split == "daily")
+                opt.splitType = FileSplitType::Daily;
+            else
+            {
+                opt.splitType = FileSplitType::NumMessages;
+                opt.messagesCount = std::atoi(split.c_str());
+            }
+        }
+        else
+            Usage("invalid argument");
+    }
+
+    std::signal(SIGINT, [](int) { gStop = 1; });
+    std::signal(SIGTERM, [](int) { gStop = 1; });
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+
+    FileProvider provider(dir / "", opt);
+    std::map<std::string, std::shared_ptr<ILogger>, std::less<>> loggers;
+
+    int listener = Listen(socketPath);
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+    std::vector<char> buffer(daemon_protocol::MaxBatchSize);
+
+    while (!gStop)
+    {
+        fds.clear();
+        fds.push_back({listener, POLLIN, 0});
+        for (const auto& client : clients)
+            fds.push_back({client.fd, POLLIN, 0});
+
+        int ready = ::poll(fds.data(), fds.size(), 1000);
+        if (ready <= 0)
+        {
+            /* Idle, or interrupted by a signal: make what we have visible */
+            provider.Flush();
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0)
+                clients.push_back({fd, PeerPid(fd)});
+        }
+
+        for (std::size_t i = 1; i < fds.size(); ++i)
+        {
+            if (!fds[i].revents)
+                continue;
+
+            auto& client = clients[i - 1];
+            auto received = ::recv(client.fd, buffer.data(), buffer.size(), 0);
+            if (received <= 0)
+            {
+                ::close(client.fd);
+                client.fd = -1;
+                continue;
+            }
+
+            bool valid = daemon_protocol::ForEachRecord(std::string_view(buffer.data(), static_cast<std::size_t>(received)),
+                                                        [&](const daemon_protocol::Record& r) {
+                auto it = loggers.find(r.Category);
+                if (it == loggers.end())
+                    it = loggers.emplace(std::string(r.Category), provider.GetLogger(std::string(r.Category))).first;
+
+                LogRecord record;
+                record.Level = r.Level;
+                record.Category = r.Category;
+                record.Timestamp = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(r.Timestamp)));
+                record.ThreadId = r.ThreadId;
+                record.ProcessId = client.pid;
+                record.Message = r.Message;
+
+                it->second->Log(record);
+            });
+
+            if (!valid)
+                std::cerr << "cxlogd: malformed batch from process " << client.pid << "\n";
+        }
+
+        clients.erase(std::remove_if(clients.begin(), clients.end(), [](const Client& c) { return c.fd < 0; }),
+                      clients.end());
+    }
+
+    for (const auto& client : clients)
+        ::close(client.fd);
+    ::close(listener);
+    ::unlink(socketPath.c_str());
+
+    provider.Shutdown(std::chrono::steady_clock::now());
+    return 0;
+}